@@ -0,0 +1,56 @@
+// Time of PhysicsSystem::step per broadphase for N random 40-120 unit boxes over the map tiles, 1% of them lightning sized
+// and 2% obstacles. The boxes are not solid, so nothing is pushed apart and every broadphase must find the same collisions.
+// setBroadphase() prints the collision check time of the previous broadphase in between.
+
+#include "physics_system.hpp"
+#include "world_init.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+int main()
+{
+	PhysicsSystem physics;
+	physics.init(nullptr);
+	RegistrySnapshot empty;
+	registry.snapshot(empty);
+
+	for (int n : { 100, 500, 1000, 2000, 5000 }) {
+		registry.restore(empty);
+		std::default_random_engine rng(42);
+		std::uniform_real_distribution<float> uniform(0, 1);
+		createMapTiles();
+		for (int i = 0; i < n; i++) {
+			Entity entity = Entity::create();
+			Motion& motion = registry.motions.emplace(entity);
+			motion.position = { leftBound + uniform(rng) * (rightBound - leftBound), topBound + uniform(rng) * (bottomBound - topBound), 30 };
+			float size = 40 + uniform(rng) * 80;
+			motion.hitbox = { size, size, size };
+			motion.solid = false;
+			if (i % 50 == 0)
+				registry.obstacles.emplace(entity);
+			if (i % 100 == 1)
+				motion.hitbox = { LIGHTNING_BB_WIDTH, LIGHTNING_BB_WIDTH, LIGHTNING_BB_HEIGHT / zConversionFactor };
+		}
+
+		for (int mode = 0; mode < broadphase_count; mode++) {
+			physics.setBroadphase((BROADPHASE)mode);
+			physics.collisions.clear();
+			physics.step(0);
+			size_t collisions = physics.collisions.size();
+
+			// the brute force pass is quadratic, fewer rounds keep the large worlds bearable
+			const int rounds = (n >= 2000 && mode == (int)BROADPHASE::BRUTE_FORCE) ? 5 : 50;
+			auto start = std::chrono::steady_clock::now();
+			for (int r = 0; r < rounds; r++) {
+				physics.collisions.clear();
+				physics.step(0);
+			}
+			double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+			printf("N=%5d  %-16s %10.1f us per step, %zu collisions\n", n, broadphase_names[mode], us, collisions);
+		}
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+// Times has() and get() on a second container for every entity of a first one, the access pattern of the systems' loops.
+// Compares ComponentContainer's sparse set to the unordered_map lookup it replaced.
+// Also times removing every entity of a tag container in creation order, the pattern of a map reset.
+
+#include "tiny_ecs.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+
+// The Entity -> array index hash map the containers used before the sparse set
+template <typename Component>
+class MapContainer
+{
+	std::unordered_map<unsigned int, unsigned int> map_entity_componentID;
+public:
+	std::vector<Component> components;
+	std::vector<Entity> entities;
+
+	Component& emplace(Entity e)
+	{
+		map_entity_componentID[e] = (unsigned int)components.size();
+		components.push_back(Component());
+		entities.push_back(e);
+		return components.back();
+	}
+	Component& get(Entity e) { return components[map_entity_componentID[e]]; }
+	bool has(Entity e) { return map_entity_componentID.count(e) > 0; }
+};
+
+struct BenchMotion
+{
+	float position[3];
+	float velocity[3];
+};
+
+// Nanoseconds per entity of the first container, a third of the entities also own the second component
+template <typename Container>
+double timeLookups(const std::vector<Entity>& entities)
+{
+	Container all, some;
+	for (size_t i = 0; i < entities.size(); i++) {
+		all.emplace(entities[i]);
+		if (i % 3 == 0)
+			some.emplace(entities[i]);
+	}
+	const int rounds = (int)(2000000 / entities.size());
+	volatile float sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (Entity e : all.entities) {
+			if (some.has(e))
+				sink = sink + some.get(e).position[0];
+			sink = sink + all.get(e).velocity[1];
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / (rounds * (double)entities.size());
+}
+
+struct BenchTag
+{
+};
+
+// Nanoseconds per remove() of n tagged entities, oldest first
+double timeTagRemoval(int n)
+{
+	const int rounds = std::max(1, 200000 / n);
+	std::vector<Entity> entities;
+	for (int i = 0; i < n; i++)
+		entities.push_back(Entity::create());
+	double ns = 0;
+	for (int r = 0; r < rounds; r++) {
+		ComponentContainer<BenchTag> tags;
+		for (Entity e : entities)
+			tags.emplace(e);
+		auto start = std::chrono::steady_clock::now();
+		for (Entity e : entities)
+			tags.remove(e);
+		ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+	return ns / (rounds * (double)n);
+}
+
+int main()
+{
+	for (int n : { 100, 1000, 10000 }) {
+		std::vector<Entity> entities;
+		for (int i = 0; i < n; i++)
+			entities.push_back(Entity::create());
+		printf("%6d entities: unordered_map %.2f ns/entity, sparse set %.2f ns/entity\n", n,
+			timeLookups<MapContainer<BenchMotion>>(entities), timeLookups<ComponentContainer<BenchMotion>>(entities));
+	}
+	for (int n : { 1000, 10000, 50000 })
+		printf("%6d tagged entities: remove %.2f ns/entity\n", n, timeTagRemoval(n));
+	return EXIT_SUCCESS;
+}
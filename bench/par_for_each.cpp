@@ -0,0 +1,57 @@
+// Time of one particle update over 10k Particles, as ParticleSystem::step() does it, in a serial loop versus
+// registry.par_for_each<Particle>() on the worker pool. Usage: bench_par_for_each [worker count...], defaulting to
+// 1, 3, 7 and one worker per hardware thread besides the main thread; the main thread works on chunks too.
+
+#include "physics_system.hpp"
+#include "tiny_ecs_registry.hpp"
+#include "worker_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+static void update(Particle& particle, float elapsed_ms)
+{
+	particle.position += particle.velocity * elapsed_ms;
+	particle.velocity.z -= GRAVITATIONAL_CONSTANT * particle.gravity;
+	particle.life -= elapsed_ms;
+}
+
+int main(int argc, char* argv[])
+{
+	const int count = 10000;
+	const int rounds = 2000;
+	const float elapsed_ms = 16;
+
+	std::vector<unsigned int> worker_counts;
+	for (int i = 1; i < argc; i++)
+		worker_counts.push_back((unsigned int)atoi(argv[i]));
+	if (worker_counts.empty())
+		worker_counts = { 1, 3, 7, std::max(std::thread::hardware_concurrency(), 1u) - 1 };
+
+	for (int i = 0; i < count; i++) {
+		Particle& particle = registry.particles.emplace(Entity::create());
+		particle.velocity = { (float)(i % 7) - 3, (float)(i % 5) - 2, (float)(i % 11) };
+		particle.life = 1e9f;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (Particle& particle : registry.particles.components)
+			update(particle, elapsed_ms);
+	double serialUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+	printf("%d particles, %u hardware threads\n", count, std::thread::hardware_concurrency());
+	printf("serial loop            %8.1f us per update\n", serialUs);
+
+	for (unsigned int worker_count : worker_counts) {
+		set_worker_count(worker_count);
+		start = std::chrono::steady_clock::now();
+		for (int r = 0; r < rounds; r++)
+			registry.par_for_each<Particle>([elapsed_ms](Entity, Particle& particle) { update(particle, elapsed_ms); });
+		double parallelUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+		printf("par_for_each %2u workers %8.1f us per update, %.2fx\n", worker_count, parallelUs, serialUs / parallelUs);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,43 @@
+// Entities created per millisecond for each enemy type, calling its create function once per enemy versus instantiating
+// a prefab of it with spawn_n(). The registry is reset between rounds with a snapshot of the empty world.
+
+#include "world_init.hpp"
+#include "tiny_ecs_registry.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int main()
+{
+	const int count = 2000;
+	const int rounds = 20;
+	Entity (*creates[])(vec2) = { createBoar, createBarbarian, createArcher, createBird, createWizard, createTroll, createBomber };
+	const char* names[] = { "boar", "barbarian", "archer", "bird", "wizard", "troll", "bomber" };
+
+	std::vector<vec2> positions;
+	for (int i = 0; i < count; i++)
+		positions.push_back({ (float)(i % 100) * 10, (float)(i / 100) * 10 });
+	RegistrySnapshot empty;
+	registry.snapshot(empty);
+
+	for (int type = 0; type < 7; type++) {
+		Prefab prefab = createPrefab(creates[type]);
+		double createMs = 0;
+		double spawnMs = 0;
+		for (int r = 0; r < rounds; r++) {
+			auto start = std::chrono::steady_clock::now();
+			for (vec2 position : positions)
+				creates[type](position);
+			createMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			registry.restore(empty);
+
+			start = std::chrono::steady_clock::now();
+			spawn_n(prefab, positions);
+			spawnMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			registry.restore(empty);
+		}
+		printf("%-10s create fn %7.0f/ms  spawn_n %7.0f/ms\n", names[type], count * rounds / createMs, count * rounds / spawnMs);
+	}
+	return EXIT_SUCCESS;
+}
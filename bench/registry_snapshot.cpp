@@ -0,0 +1,46 @@
+// Times ECSRegistry::snapshot() and restore() on a typical world: 500 entities with a motion, render request and midground,
+// 60 of them enemies with their usual components, and every tenth one with a text.
+
+#include "tiny_ecs_registry.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int main()
+{
+	for (int i = 0; i < 500; i++) {
+		Entity entity = Entity::create();
+		Motion& motion = registry.motions.emplace(entity);
+		motion.position = vec3(i, i, 0);
+		registry.renderRequests.emplace(entity);
+		registry.midgrounds.emplace(entity);
+		if (i < 60) {
+			registry.enemies.emplace(entity);
+			registry.boars.emplace(entity);
+			registry.staminas.emplace(entity);
+			registry.cooldowns.emplace(entity);
+			registry.animationControllers.emplace(entity);
+			registry.knockables.emplace(entity);
+			registry.trappables.emplace(entity);
+		}
+		if (i % 10 == 0) {
+			registry.texts.emplace(entity).value = "hello world";
+		}
+	}
+
+	const int rounds = 2000;
+	RegistrySnapshot snapshot;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		registry.snapshot(snapshot);
+	auto snapshotted = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		registry.restore(snapshot);
+	auto restored = std::chrono::steady_clock::now();
+
+	printf("snapshot %.1f us, restore %.1f us\n",
+		std::chrono::duration<double, std::micro>(snapshotted - start).count() / rounds,
+		std::chrono::duration<double, std::micro>(restored - snapshotted).count() / rounds);
+	return EXIT_SUCCESS;
+}
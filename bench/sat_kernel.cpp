@@ -0,0 +1,105 @@
+// Pair tests per microsecond of the fixed-size SAT kernel satCollide() versus the vector based polygonsCollide(), for random
+// rotated box/box and triangle/box pairs placed so that a quarter to a half of them overlap. Every pair is also checked with both
+// functions, and the benchmark fails if they ever disagree.
+
+#include "physics_system.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+struct PairSet
+{
+	std::vector<SatPolygon> satA, satB;
+	std::vector<std::vector<vec2>> polygonA, polygonB;
+};
+
+static std::vector<vec2> randomBox(std::default_random_engine& rng)
+{
+	std::uniform_real_distribution<float> uniform(0, 1);
+	vec2 centre = { uniform(rng) * 100, uniform(rng) * 100 };
+	vec2 half = vec2(10 + uniform(rng) * 40, 10 + uniform(rng) * 40) / 2.f;
+	float angle = uniform(rng) * 6.2831853f;
+	return {
+		centre + rotate(vec2(+half.x, +half.y), angle),
+		centre + rotate(vec2(-half.x, +half.y), angle),
+		centre + rotate(vec2(-half.x, -half.y), angle),
+		centre + rotate(vec2(+half.x, -half.y), angle)
+	};
+}
+
+static std::vector<vec2> randomTriangle(std::default_random_engine& rng)
+{
+	std::uniform_real_distribution<float> uniform(0, 1);
+	vec2 centre = { uniform(rng) * 100, uniform(rng) * 100 };
+	std::vector<vec2> triangle;
+	for (int v = 0; v < 3; v++)
+		triangle.push_back(centre + rotate(vec2(10 + uniform(rng) * 20, 0), v * 2.0943951f + uniform(rng)));
+	return triangle;
+}
+
+static SatPolygon toSat(const std::vector<vec2>& polygon)
+{
+	return polygon.size() == 3
+		? satTriangle(polygon[0], polygon[1], polygon[2])
+		: satQuad(polygon[0], polygon[1], polygon[2], polygon[3]);
+}
+
+static void run(const char* name, const PairSet& pairs)
+{
+	const size_t count = pairs.satA.size();
+	const int rounds = 20;
+
+	size_t mismatches = 0;
+	size_t hits = 0;
+	for (size_t i = 0; i < count; i++) {
+		bool sat = satCollide(pairs.satA[i], pairs.satB[i]);
+		mismatches += sat != polygonsCollide(pairs.polygonA[i], pairs.polygonB[i]);
+		hits += sat;
+	}
+
+	volatile size_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (size_t i = 0; i < count; i++)
+			sink += satCollide(pairs.satA[i], pairs.satB[i]);
+	double satUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++)
+		for (size_t i = 0; i < count; i++)
+			sink += polygonsCollide(pairs.polygonA[i], pairs.polygonB[i]);
+	double polygonUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%-8s satCollide %6.1f pairs/us  polygonsCollide %6.1f pairs/us  %zu of %zu overlap, %zu mismatches\n",
+		name, count * rounds / satUs, count * rounds / polygonUs, hits, count, mismatches);
+	if (mismatches > 0) {
+		fprintf(stderr, "satCollide and polygonsCollide disagree on %zu %s pairs\n", mismatches, name);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main()
+{
+	const int count = 200000;
+	std::default_random_engine rng(42);
+
+	PairSet boxBox, triangleBox;
+	for (int i = 0; i < count; i++) {
+		boxBox.polygonA.push_back(randomBox(rng));
+		boxBox.polygonB.push_back(randomBox(rng));
+		triangleBox.polygonA.push_back(randomTriangle(rng));
+		triangleBox.polygonB.push_back(randomBox(rng));
+	}
+	for (PairSet* pairs : { &boxBox, &triangleBox }) {
+		for (const std::vector<vec2>& polygon : pairs->polygonA)
+			pairs->satA.push_back(toSat(polygon));
+		for (const std::vector<vec2>& polygon : pairs->polygonB)
+			pairs->satB.push_back(toSat(polygon));
+	}
+
+	run("box/box", boxBox);
+	run("tri/box", triangleBox);
+	return EXIT_SUCCESS;
+}
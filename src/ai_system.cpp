@@ -17,11 +17,11 @@ const float BIRD_SWOOP_DURATION = 500;
 const float BIRD_COOLDOWN_TIME = 1000;
 const float BIRD_TURNING_SPEED = 0.002;
 
-
-AISystem::AISystem(std::default_random_engine& rng, SoundSystem* sound)
+AISystem::AISystem(std::default_random_engine& rng, SoundSystem* sound, PhysicsSystem* physics)
 {
     this->rng = rng;
 	this->sound = sound;
+    this->physics = physics;
 }
 
 vec2 AISystem::randomDirection()
@@ -86,14 +86,14 @@ vec2 AISystem::chooseDirection(Motion& motion, vec3 playerPosition)
         radius = d;
     }
 
-    std::vector<Entity>& allObstacles = registry.obstacles.entities;
+    std::vector<Entity> nearbyObstacles = physics->obstaclesNear(vec2(motion.position), radius);
     std::vector<Entity> obstacles;
     // only include obstacles within the range we care about
     // won't work for extremely large obstacles (where none of their hitbox vertices will be inside the radius)
-    std::copy_if(allObstacles.begin(), allObstacles.end(), std::back_inserter(obstacles), 
+    std::copy_if(nearbyObstacles.begin(), nearbyObstacles.end(), std::back_inserter(obstacles), 
         [&motion, radius](Entity obstacle) {
             Motion& obstacleMotion = registry.motions.get(obstacle);
-            std::vector<vec3> vertices = boundingBoxVertices(obstacleMotion);
+            std::array<vec3, 8> vertices = boundingBoxVertices(obstacleMotion);
             for (auto& vertex : vertices) {
                 float d = distance(motion.position, vertex);
                 if (d < radius)
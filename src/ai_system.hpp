@@ -2,12 +2,13 @@
 
 #include "tiny_ecs_registry.hpp"
 #include "sound_system.hpp"
+#include "physics_system.hpp"
 
 #include <random>
 
 class AISystem {
 public:
-	AISystem(std::default_random_engine& rng, SoundSystem* sound);
+	AISystem(std::default_random_engine& rng, SoundSystem* sound, PhysicsSystem* physics);
 	void step(float elapsed_ms);
 	void boarReset(Entity boar);
 
@@ -58,4 +59,6 @@ private:
 	std::uniform_real_distribution<float> uniform_dist; // number between 0..1
 
 	SoundSystem* sound;
+	// Pathfinding looks up the obstacles near an enemy in the static collision layer
+	PhysicsSystem* physics;
 };
\ No newline at end of file
@@ -21,11 +21,11 @@ void AnimationController::changeState(Entity entity, AnimationState newState)
 	if (currentState != newState)
 	{
 		currentState = newState;
-		animations[currentState].currentFrame = 0; 
-		animations[currentState].elapsedTime = 0.0f;
+		animations[(int)currentState].currentFrame = 0; 
+		animations[(int)currentState].elapsedTime = 0.0f;
 
 		// Update used texture in render request
-		Animation newAnimation = animations.at(newState);
+		Animation newAnimation = animations[(int)newState];
 		
 		RenderRequest& renderRequest = registry.renderRequests.get(entity);
 		renderRequest.used_texture = newAnimation.spritesheet;
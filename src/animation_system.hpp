@@ -1,8 +1,9 @@
-#include <unordered_map>
+#include <array>
 #include "render_components.hpp"
 #pragma once
 
 enum class AnimationState { Idle, Running, Jumping, Dead, Attack, Fading, Flying, Swooping, Default};
+const int animation_state_count = (int)AnimationState::Default + 1;
 
 // Represents a single animation sequence, including frame timing, frame count, and spritesheet
 // Gets looked up if EFFECT_ASSET_ID is ANIMATED
@@ -24,14 +25,15 @@ struct Animation
 // Controls and manages animations for an entity by storing animations mapped to states
 struct AnimationController	
 {
-	std::unordered_map<AnimationState, Animation> animations;
+	// Indexed by (int)AnimationState, a flat array so that copying a controller (see Prefab) does not allocate
+	std::array<Animation, animation_state_count> animations;
 	AnimationState currentState;
 
-	AnimationController() : currentState(AnimationState::Idle) {}
+	AnimationController() : animations(), currentState(AnimationState::Idle) {}
 
 	void addAnimation(AnimationState state, float frameTime, int numFrames, TEXTURE_ASSET_ID spritesheet)
 	{
-		animations[state] = Animation(frameTime, numFrames, spritesheet);
+		animations[(int)state] = Animation(frameTime, numFrames, spritesheet);
 	}
     
 	void changeState(Entity entity, AnimationState newState);
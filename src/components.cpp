@@ -8,6 +8,22 @@
 Debug debugging;
 float death_timer_counter_ms = 3000;
 
+const char* const enemy_type_names[enemy_type_count] = {
+	"BOAR", "BARBARIAN", "ARCHER", "BIRD", "WIZARD", "TROLL", "BOMBER"
+};
+const char* const damaging_type_names[damaging_type_count] = {
+	"arrow", "fireball", "lightning"
+};
+const char* const collectible_type_names[collectible_type_count] = {
+	"HEART", "TRAP", "PHANTOM_TRAP", "BOW", "BOMB"
+};
+const char* const trap_type_names[trap_type_count] = {
+	"trap", "phantom_trap"
+};
+const char* const spawnable_type_names[spawnable_type_count] = {
+	"bird", "boar", "barbarian", "archer", "wizard", "troll", "bomber", "heart", "collectible_trap"
+};
+
 // Very, VERY simple OBJ loader from https://github.com/opengl-tutorials/ogl tutorial 7
 // (modified to also read vertex color and omit uv and normals)
 bool Mesh::loadFromOBJFile(std::string obj_path, std::vector<ColoredVertex>& out_vertices, std::vector<uint16_t>& out_vertex_indices, vec2& out_size)
@@ -1,6 +1,7 @@
 #pragma once
 #include "common.hpp"
 #include <vector>
+#include <string>
 #include <unordered_map>
 
 /*
@@ -42,16 +43,99 @@ struct Dash {
 	float dashDuration = 0.2f;  // Duration of Dash
 };
 
+// Type ids compared by gameplay code. The name tables below are only for log output
+// and save files, and keep the strings older saves were written with.
+enum class ENEMY_TYPE {
+	BOAR,
+	BARBARIAN,
+	ARCHER,
+	BIRD,
+	WIZARD,
+	TROLL,
+	BOMBER,
+	ENEMY_TYPE_COUNT
+};
+const int enemy_type_count = (int)ENEMY_TYPE::ENEMY_TYPE_COUNT;
+
+enum class DAMAGING_TYPE {
+	ARROW,
+	FIREBALL,
+	LIGHTNING,
+	DAMAGING_TYPE_COUNT
+};
+const int damaging_type_count = (int)DAMAGING_TYPE::DAMAGING_TYPE_COUNT;
+
+enum class COLLECTIBLE_TYPE {
+	HEART,
+	TRAP,
+	PHANTOM_TRAP,
+	BOW,
+	BOMB,
+	COLLECTIBLE_TYPE_COUNT
+};
+const int collectible_type_count = (int)COLLECTIBLE_TYPE::COLLECTIBLE_TYPE_COUNT;
+
+enum class TRAP_TYPE {
+	DAMAGE,
+	PHANTOM,
+	TRAP_TYPE_COUNT
+};
+const int trap_type_count = (int)TRAP_TYPE::TRAP_TYPE_COUNT;
+
+// Everything the SpawnManager spawns, in initial spawn order (enemies first, collectibles last)
+enum class SPAWNABLE_TYPE {
+	BIRD,
+	BOAR,
+	BARBARIAN,
+	ARCHER,
+	WIZARD,
+	TROLL,
+	BOMBER,
+	HEART,
+	COLLECTIBLE_TRAP,
+	SPAWNABLE_TYPE_COUNT
+};
+const int spawnable_type_count = (int)SPAWNABLE_TYPE::SPAWNABLE_TYPE_COUNT;
+
+extern const char* const enemy_type_names[enemy_type_count];
+extern const char* const damaging_type_names[damaging_type_count];
+extern const char* const collectible_type_names[collectible_type_count];
+extern const char* const trap_type_names[trap_type_count];
+extern const char* const spawnable_type_names[spawnable_type_count];
+
+// Looks a name up in one of the tables above, returns false if it is not there
+template <typename Type, size_t N>
+bool typeFromName(const char* const (&names)[N], const std::string& name, Type& out)
+{
+	for (size_t i = 0; i < N; i++) {
+		if (name == names[i]) {
+			out = (Type)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Fields read by the AI, physics and collision loops every frame
 struct Enemy
 {
 	int health = 100;
-	int maxHealth = 100;
 	int damage = 10;
-	std::string type;
 	unsigned int cooldown = 0;
 	float pathfindTime = 0;
+};
+
+// Fields only read on spawn, death, tutorials and saving: the cold part of Enemy, see registry.enemies.cold(e)
+struct EnemyInfo
+{
+	int maxHealth = 100;
+	ENEMY_TYPE type = ENEMY_TYPE::BOAR;
 	int points = 1;
 };
+template <>
+struct cold_part<Enemy> {
+	typedef EnemyInfo type;
+};
 
 struct Trappable {
 	bool isTrapped = false;
@@ -63,7 +147,7 @@ struct Explosion {
 };
 
 struct Damaging {
-	std::string type = "arrow"; // default type
+	DAMAGING_TYPE type = DAMAGING_TYPE::ARROW; // default type
 	unsigned int damage = 10;
 	Entity excludedEntity;
 };
@@ -104,6 +188,15 @@ struct HealthBar {
 	}
 };
 
+// Attaches an entity to a parent: its position follows the parent's plus offset, and it is destroyed with the parent
+// Positions are propagated once per frame, parents before children, see RenderSystem::updateAttachments()
+struct Attachment
+{
+	Entity parent;
+	vec3 offset = { 0, 0, 0 };
+	bool aboveParent = false; // offset.z is measured from the top of the parent's sprite rather than its centre
+};
+
 struct StaminaBar {
 	Entity meshEntity;
 	Entity frameEntity;
@@ -123,7 +216,7 @@ struct Collectible
 	float timer = 0; 
 	vec2 position = { 0, 0 };
 	vec2 scale = { 3, 3 };
-	std::string type;
+	COLLECTIBLE_TYPE type = COLLECTIBLE_TYPE::HEART;
 
 };
 
@@ -152,17 +245,18 @@ struct PhantomTrap : public BaseTrap
 };
 
 // All data relevant to the shape and motion of entities
+// Fields read by the physics integration come first so they share a cache line
 struct Motion {
 	vec3 position = { 0, 0, 0 };
-	float angle = 0;
 	vec3 velocity = { 0, 0, 0 };
-	float speed = 0;			// max voluntary speed
-	vec2 scale = { 10, 10 };	// only for rendering
-	vec2 facing = { 0, 0 };		// direction the entity is facing
+	float gravity = 1.0;			// 1 means affected by gravity normally, 0 is no gravity
 
 	// Hitbox
 	vec3 hitbox = { 0, 0, 0 };
-	float gravity = 1.0;			// 1 means affected by gravity normally, 0 is no gravity
+	float angle = 0;
+	float speed = 0;			// max voluntary speed
+	vec2 facing = { 0, 0 };		// direction the entity is facing
+	vec2 scale = { 10, 10 };	// only for rendering
 	bool solid = false;
 };
 
@@ -243,6 +337,8 @@ struct Text {
 	vec2 anchoredWorldOffset;
 	TEXT_ALIGNMENT alignment = TEXT_ALIGNMENT::LEFT;
 	float lineSpacing = 1.3f;
+	// Start of every line relative to the alignment position at scale 1, laid out by the renderer when the text changes
+	std::vector<vec2> lineOffsets;
 };
 
 struct SlideUp {
@@ -356,7 +452,7 @@ struct Bomber {
 struct Heart { unsigned int health = 20; };
 struct CollectibleTrap 
 { 
-	std::string type = "trap"; 
+	TRAP_TYPE type = TRAP_TYPE::DAMAGE;
 };
 struct Bow {};
 struct CollectibleBomb {};
@@ -95,9 +95,11 @@ nlohmann::json GameSaveManager::serialize_container(const ComponentContainer<Com
 		entities.push_back(entity.getId());
 	}
 
-	// save components of entities
-	for (const auto& component : container.components) {
-		components.push_back(serialize_component(component));
+	// save components of entities, with the fields of their cold parts in the same object
+	for (size_t i = 0; i < container.components.size(); i++) {
+		json component = serialize_component(container.components[i]);
+		serialize_cold_part(component, container.cold_components[i]);
+		components.push_back(component);
 	}
 
 	j["entities"] = entities;
@@ -213,14 +215,17 @@ template<>
 nlohmann::json GameSaveManager::serialize_component<Enemy>(const Enemy& enemy) {
 	nlohmann::json j;
 	j["health"] = enemy.health;
-	j["maxHealth"] = enemy.maxHealth;
 	j["damage"] = enemy.damage;
-	j["type"] = enemy.type;
 	j["cooldown"] = enemy.cooldown;
 	j["pathfindTime"] = enemy.pathfindTime;
 	return j;
 }
 
+void GameSaveManager::serialize_cold_part(nlohmann::json& j, const EnemyInfo& info) {
+	j["maxHealth"] = info.maxHealth;
+	j["type"] = enemy_type_names[(int)info.type];
+}
+
 template<>
 nlohmann::json GameSaveManager::serialize_component<Motion>(const Motion& motion) {
 	nlohmann::json j;
@@ -281,7 +286,7 @@ nlohmann::json GameSaveManager::serialize_component<Damaged>(const Damaged& dama
 template<>
 nlohmann::json GameSaveManager::serialize_component<Damaging>(const Damaging& damaging) {
 	nlohmann::json j;
-	j["type"] = damaging.type;
+	j["type"] = damaging_type_names[(int)damaging.type];
 	j["damage"] = damaging.damage;
 	return j;
 }
@@ -887,21 +892,24 @@ void GameSaveManager::createTargetAreaDeserialization(std::map<std::string, nloh
 }
 
 void GameSaveManager::createDamagingsDeserialization(std::map<std::string, nlohmann::json> componentsMap) {
-	std::string type = componentsMap[DAMAGINGS]["type"];
+	DAMAGING_TYPE type;
+	if (!typeFromName(damaging_type_names, componentsMap[DAMAGINGS]["type"].get<std::string>(), type)) {
+		return;
+	}
 	float damage = (float) componentsMap[DAMAGINGS]["damage"];
 
 	vec3 position = { (float)componentsMap[MOTIONS]["position"][0], (float)componentsMap[MOTIONS]["position"][1], (float)componentsMap[MOTIONS]["position"][2] };
 	vec3 velocity = { (float)componentsMap[MOTIONS]["velocity"][0], (float)componentsMap[MOTIONS]["velocity"][1], (float)componentsMap[MOTIONS]["velocity"][2] };
 
-	if (type == "arrow") {
+	if (type == DAMAGING_TYPE::ARROW) {
 		createArrow(position, velocity, damage);
 	}
-	else if (type == "fireball") {
+	else if (type == DAMAGING_TYPE::FIREBALL) {
 		float angle = (float) componentsMap[MOTIONS]["angle"];
 		vec2 direction = vec2(cos(angle), sin(angle));
 		createFireball(position, direction);
 	}
-	else if (type == "lightning") {
+	else if (type == DAMAGING_TYPE::LIGHTNING) {
 		createLightning(position);
 	}
 }
@@ -968,9 +976,7 @@ void GameSaveManager::handleDeathTimer(Entity& entity, std::map<std::string, nlo
 	AnimationController& animationController = registry.animationControllers.get(entity);
 	animationController.changeState(entity, AnimationState::Dead);
 	deathTimer.timer = componentsMap[DEATHTIMERS]["timer"];
-	HealthBar& hpbar = registry.healthBars.get(entity);
-	registry.remove_all_components_of(hpbar.meshEntity);
-	registry.remove_all_components_of(hpbar.frameEntity);
+	registry.destroy_children(entity);
 	registry.healthBars.remove(entity);
 }
 
@@ -997,7 +1003,7 @@ void GameSaveManager::handleEnemy(Entity& entity, std::map<std::string, nlohmann
 	Enemy& enemy = registry.enemies.get(entity);
 	enemy.health = componentsMap[ENEMIES]["health"];
 	enemy.damage = componentsMap[ENEMIES]["damage"];
-	enemy.type = componentsMap[ENEMIES]["type"];
+	typeFromName(enemy_type_names, componentsMap[ENEMIES]["type"].get<std::string>(), registry.enemies.cold(entity).type); // saves store the type name
 	enemy.cooldown = componentsMap[ENEMIES]["cooldown"];
 	enemy.pathfindTime = componentsMap[ENEMIES]["pathfindTime"];
 }
@@ -1041,7 +1047,7 @@ void GameSaveManager::handleBarbarian(Entity& entity, std::map<std::string, nloh
 	Enemy& enemy = registry.enemies.get(entity);
 	enemy.health = componentsMap[ENEMIES]["health"];
 	enemy.damage = componentsMap[ENEMIES]["damage"];
-	enemy.type = componentsMap[ENEMIES]["type"];
+	typeFromName(enemy_type_names, componentsMap[ENEMIES]["type"].get<std::string>(), registry.enemies.cold(entity).type); // saves store the type name
 	enemy.cooldown = componentsMap[ENEMIES]["cooldown"];
 	enemy.pathfindTime = componentsMap[ENEMIES]["pathfindTime"];
 }
@@ -111,6 +111,10 @@ private:
 	template <typename Component>
 	nlohmann::json serialize_component(const Component& component);
 
+	// Adds the fields of a component's cold part to the component's json, see cold_part
+	void serialize_cold_part(nlohmann::json&, const NoColdPart&) {}
+	void serialize_cold_part(nlohmann::json& j, const EnemyInfo& info);
+
 	// Deserialization
 	void groupComponentsForEntities(const json& j);
 
@@ -11,6 +11,9 @@ struct PlayerResourceUI {
 	Entity staminaTextEntity;
     vec2 hpMaxSize = {150.f, 20.f};
     vec2 staminaMaxSize = {150.f, 20.f};
+	// Values the texts and meters currently show, -1 forces an update
+	int shownHealth = -1;
+	int shownStamina = -1;
 };
 
 struct GameScore {
@@ -20,6 +23,8 @@ struct GameScore {
 	int highScoreMinutes = 0;
 	int highScoreSeconds = 0;
     Entity textEntity;
+	// Score the text currently shows, -1 forces an update
+	int shownScore = -1;
 };
 
 struct GameTimer {
@@ -29,7 +29,7 @@ int main()
 	PhysicsSystem physics;
 	ParticleSystem particles;
 	SoundSystem sound;
-	AISystem ai = AISystem(rng, &sound);
+	AISystem ai = AISystem(rng, &sound, &physics);
 	Camera camera;
 	GameSaveManager saveManager;
 	SpawnManager spawnManager;
@@ -74,14 +74,21 @@ int main()
 			physics.step(elapsed_ms);
 			particles.step(elapsed_ms);
 			world.step(elapsed_ms);
+			// Sync point: entities the world destroyed this step must not take part in the collisions below
+			registry.flush_deferred();
             world.handle_collisions();
 			ai.step(elapsed_ms);
 			renderer.step(elapsed_ms);
 			sound.step(elapsed_ms);
 			spawnManager.step(elapsed_ms);
+
+			// Sync point: apply entity destruction and component changes queued by the systems above
+			registry.flush_deferred();
 		}
 
 		renderer.draw();
+		// Changes are consumed by the systems and the renderer within a frame
+		registry.end_frame();
 		
 	}
 	return 0;
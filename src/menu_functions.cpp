@@ -3,7 +3,7 @@
 #include "world_system.hpp"
 
 Entity WorldSystem::createHelpMenu(vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	registry.pauseMenuComponents.emplace(entity);
 
@@ -29,7 +29,7 @@ void WorldSystem::exitHelpMenu() {
 }
 
 Entity WorldSystem::createPauseMenu(vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	registry.pauseMenuComponents.emplace(entity);
 
@@ -57,7 +57,7 @@ void WorldSystem::exitPauseMenu() {
 
 //Tutorial at the start
 Entity WorldSystem::createTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.tutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -81,7 +81,7 @@ void WorldSystem::exitTutorial() {
 }
 
 Entity WorldSystem::createBoarTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.enemyTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -98,7 +98,7 @@ Entity WorldSystem::createBoarTutorial(vec2 windowSize) {
     return entity;
 }
 Entity WorldSystem::createBirdTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.enemyTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -115,7 +115,7 @@ Entity WorldSystem::createBirdTutorial(vec2 windowSize) {
     return entity;
 }
 Entity WorldSystem::createWizardTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.enemyTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -132,7 +132,7 @@ Entity WorldSystem::createWizardTutorial(vec2 windowSize) {
     return entity;
 }
 Entity WorldSystem::createTrollTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.enemyTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -149,7 +149,7 @@ Entity WorldSystem::createTrollTutorial(vec2 windowSize) {
     return entity;
 }
 Entity WorldSystem::createArcherTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.enemyTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -166,7 +166,7 @@ Entity WorldSystem::createArcherTutorial(vec2 windowSize) {
     return entity;
 }
 Entity WorldSystem::createBarbarianTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.enemyTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -184,7 +184,7 @@ Entity WorldSystem::createBarbarianTutorial(vec2 windowSize) {
 }
 
 Entity WorldSystem::createBomberTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.enemyTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -208,7 +208,7 @@ void WorldSystem::exitEnemyTutorial() {
 }
 
 Entity WorldSystem::createHeartTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.collectibleTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -226,7 +226,7 @@ Entity WorldSystem::createHeartTutorial(vec2 windowSize) {
 }
 
 Entity WorldSystem::createTrapTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.collectibleTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -244,7 +244,7 @@ Entity WorldSystem::createTrapTutorial(vec2 windowSize) {
 }
 
 Entity WorldSystem::createPhantomTrapTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.collectibleTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -262,7 +262,7 @@ Entity WorldSystem::createPhantomTrapTutorial(vec2 windowSize) {
 }
 
 Entity WorldSystem::createBowTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.collectibleTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
@@ -280,7 +280,7 @@ Entity WorldSystem::createBowTutorial(vec2 windowSize) {
 }
 
 Entity WorldSystem::createBombTutorial(vec2 windowSize) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.collectibleTutorialComponents.emplace(entity);
 
     Foreground& fg = registry.foregrounds.emplace(entity);
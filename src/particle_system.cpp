@@ -21,14 +21,15 @@ void ParticleSystem::init(RenderSystem* renderer)
 
 void ParticleSystem::step(float elapsed_ms)
 {
-    for (size_t i = 0; i < registry.particles.size(); i++) {
-        Entity entity = registry.particles.entities[i];
-        Particle& particle = registry.particles.components[i];
+    registry.par_for_each<Particle>([elapsed_ms](Entity, Particle& particle) {
         particle.position += particle.velocity * elapsed_ms;
         particle.velocity.z -= GRAVITATIONAL_CONSTANT * particle.gravity;
         particle.life -= elapsed_ms;
-        if (particle.life < 0) {
-            registry.remove_all_components_of(entity);
+    });
+    // destroying is not allowed in the parallel part
+    for (size_t i = 0; i < registry.particles.size(); i++) {
+        if (registry.particles.components[i].life < 0) {
+            registry.destroy_deferred(registry.particles.entities[i]);
         }
     }
 }
@@ -114,7 +115,7 @@ void ParticleSystem::drawDash(const GLuint program, mat3& projection)
 
 Entity ParticleSystem::createSmokeParticle(vec3 position, vec2 size)
 {
-    Entity entity = Entity();
+    Entity entity = Entity::create();
 
     Particle& particle = registry.particles.emplace(entity);
     particle.position = position;
@@ -129,7 +130,7 @@ Entity ParticleSystem::createSmokeParticle(vec3 position, vec2 size)
 
 Entity ParticleSystem::createDashParticle(vec3 position, vec2 size)
 {
-    Entity entity = Entity();
+    Entity entity = Entity::create();
 
     Particle& particle = registry.particles.emplace(entity);
     particle.position = position;
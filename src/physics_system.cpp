@@ -2,21 +2,25 @@
 #include "world_init.hpp"
 #include "render_system.hpp"
 #include <iostream>
+#include <chrono>
+#include <climits>
 #include <glm/gtx/string_cast.hpp>
 
-static std::vector<vec2> getPolygonOfBoundingBox(const Motion& motion)
+const char* const broadphase_names[broadphase_count] = {
+	"brute force", "spatial hash", "sweep and prune"
+};
+
+static SatPolygon getPolygonOfBoundingBox(const Motion& motion)
 {
 	vec2 pos = { motion.position.x, motion.position.z };
-	std::vector<vec2> polygon{
+	return satQuad(
 		pos + rotate(vec2(+motion.hitbox.x, +motion.hitbox.z) / 2.f, motion.angle),
 		pos + rotate(vec2(-motion.hitbox.x, +motion.hitbox.z) / 2.f, motion.angle),
 		pos + rotate(vec2(-motion.hitbox.x, -motion.hitbox.z) / 2.f, motion.angle),
-		pos + rotate(vec2(+motion.hitbox.x, -motion.hitbox.z) / 2.f, motion.angle)
-	};
-	return polygon;
+		pos + rotate(vec2(+motion.hitbox.x, -motion.hitbox.z) / 2.f, motion.angle));
 }
 
-static bool collides(const Motion& motionA, const Motion& motionB, const std::vector<vec2>& polygonA, const std::vector<vec2>& polygonB)
+static bool collides(const Motion& motionA, const Motion& motionB, const SatPolygon& polygonA, const SatPolygon& polygonB)
 {
 	// Check if there's overlap along the Y axis
 	if (motionA.position.y > motionB.position.y + ((motionB.hitbox.y + motionA.hitbox.y) / 2.0f)) {
@@ -43,20 +47,11 @@ static bool collides(const Motion& motionA, const Motion& motionB, const std::ve
 	}
 
 	// Check if the polygons collide
-	return polygonsCollide(polygonA, polygonB);
+	return satCollide(polygonA, polygonB);
 }
 
 void PhysicsSystem::handleBoundsCheck() {
-	ComponentContainer<Motion>& motion_container = registry.motions;
-
-	for (uint i = 0; i < motion_container.components.size(); i++) {
-		if (registry.birds.has(motion_container.entities[i]) || 
-			registry.mapTiles.has(motion_container.entities[i]) ||
-			registry.explosions.has(motion_container.entities[i])) {
-			continue;
-		}
-
-		Motion& motion = motion_container.components[i];
+	registry.view<Motion>(exclude<Bird, MapTile, Explosion>).each([&](Entity entity, Motion& motion) {
 		float halfScaleX = abs(motion.scale.x) / 2;
 		float halfScaleY = abs(motion.scale.y) / 2;
 
@@ -75,70 +70,658 @@ void PhysicsSystem::handleBoundsCheck() {
 		else if (motion.position.y + halfScaleY > bottomBound) {
 			motion.position.y = bottomBound - halfScaleY;
 		}
+	});
+}
+
+// The extent on the ground plane that collides() tests before the polygons: the larger of width and height along x, the depth along y
+static void groundExtent(const Motion& motion, vec2& low, vec2& high)
+{
+	vec2 half = vec2(max(motion.hitbox.x, motion.hitbox.z), motion.hitbox.y) / 2.f;
+	low = vec2(motion.position) - half;
+	high = vec2(motion.position) + half;
+}
+
+// Broadphase grid: every Motion goes into the cells its extent covers, and only entities sharing a cell are tested
+// The cells are about the size of a character, larger things like lightning and explosions cover several
+const float COLLISION_CELL_SIZE = 128.f;
+// Entities covering more cells are tested against everything instead, so one huge hitbox cannot flood the grid
+const int MAX_CELLS_PER_ENTITY = 64;
+
+static unsigned int collisionCellHash(int x, int y)
+{
+	return ((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u);
+}
+
+// Appends the pairs of moving bodies (motion indices i < j) whose extents overlap on the ground plane, see bodyExtent()
+void PhysicsSystem::spatialHashPairs()
+{
+	ComponentContainer<Motion>& motions = registry.motions;
+	largeEntities.clear();
+	cellRanges.resize(motions.size());
+
+	auto overlaps = [&](unsigned int a, unsigned int b) {
+		const CellRange& ra = cellRanges[a];
+		const CellRange& rb = cellRanges[b];
+		return ra.low.x <= rb.high.x && rb.low.x <= ra.high.x && ra.low.y <= rb.high.y && rb.low.y <= ra.high.y;
+	};
+
+	size_t entryCount = 0;
+	for (unsigned int i : dynamicMotions) {
+		CellRange& range = cellRanges[i];
+		bodyExtent(i, range.low, range.high);
+		range.x0 = (int)floor(range.low.x / COLLISION_CELL_SIZE);
+		range.y0 = (int)floor(range.low.y / COLLISION_CELL_SIZE);
+		range.x1 = (int)floor(range.high.x / COLLISION_CELL_SIZE);
+		range.y1 = (int)floor(range.high.y / COLLISION_CELL_SIZE);
+		range.large = (long long)(range.x1 - range.x0 + 1) * (range.y1 - range.y0 + 1) > MAX_CELLS_PER_ENTITY;
+		if (range.large) {
+			largeEntities.push_back(i);
+		}
+		else {
+			entryCount += (range.x1 - range.x0 + 1) * (range.y1 - range.y0 + 1);
+		}
+	}
+
+	// Large entities against everything, a pair of two large ones only once
+	for (unsigned int i : largeEntities) {
+		for (unsigned int j : dynamicMotions) {
+			if (j != i && !(cellRanges[j].large && j < i) && overlaps(i, j)) {
+				candidatePairs.push_back({ min(i, j), max(i, j) });
+			}
+		}
+	}
+
+	// Counting sort of the (cell, entity) entries into hash buckets
+	size_t bucketCount = 64;
+	while (bucketCount < entryCount) {
+		bucketCount *= 2;
+	}
+	unsigned int mask = (unsigned int)bucketCount - 1;
+	bucketStarts.assign(bucketCount, 0);
+	for (unsigned int i : dynamicMotions) {
+		const CellRange& range = cellRanges[i];
+		if (range.large) continue;
+		for (int x = range.x0; x <= range.x1; x++)
+			for (int y = range.y0; y <= range.y1; y++)
+				bucketStarts[collisionCellHash(x, y) & mask]++;
+	}
+	unsigned int start = 0;
+	for (unsigned int& bucket : bucketStarts) {
+		unsigned int size = bucket;
+		bucket = start;
+		start += size;
+	}
+	// filling advances every bucket's start to its end, which is where the next bucket starts
+	cellEntries.resize(entryCount);
+	for (unsigned int i : dynamicMotions) {
+		const CellRange& range = cellRanges[i];
+		if (range.large) continue;
+		for (int x = range.x0; x <= range.x1; x++)
+			for (int y = range.y0; y <= range.y1; y++)
+				cellEntries[bucketStarts[collisionCellHash(x, y) & mask]++] = { x, y, i };
+	}
+
+	// Pairs sharing a cell, a bucket can also hold other cells that hash the same
+	for (size_t b = 0, begin = 0; b < bucketCount; begin = bucketStarts[b++]) {
+		for (size_t m = begin; m < bucketStarts[b]; m++) {
+			const CellEntry& a = cellEntries[m];
+			for (size_t k = m + 1; k < bucketStarts[b]; k++) {
+				const CellEntry& other = cellEntries[k];
+				if (a.x != other.x || a.y != other.y || !overlaps(a.index, other.index)) continue;
+				// two entities can share several cells, the pair is only taken from the cell holding the low corner of their overlap
+				const CellRange& ra = cellRanges[a.index];
+				const CellRange& rb = cellRanges[other.index];
+				if (max(ra.x0, rb.x0) != a.x || max(ra.y0, rb.y0) != a.y) continue;
+				candidatePairs.push_back({ min(a.index, other.index), max(a.index, other.index) });
+			}
+		}
 	}
 }
 
-void PhysicsSystem::checkCollisions()
+// Above this many new boxes in a frame the endpoints are sorted and swept from scratch instead of insertion sorted
+const unsigned int SWEEP_REBUILD_THRESHOLD = 64;
+
+static unsigned long long sweepPairKey(unsigned int a, unsigned int b)
+{
+	return a < b ? ((unsigned long long)a << 32) | b : ((unsigned long long)b << 32) | a;
+}
+
+void PhysicsSystem::addSweepPair(unsigned long long key)
+{
+	sweepPairSlots[key] = (unsigned int)sweepPairs.size();
+	sweepPairs.push_back(key);
+}
+
+void PhysicsSystem::removeSweepPair(unsigned long long key)
+{
+	auto slot = sweepPairSlots.find(key);
+	if (slot == sweepPairSlots.end()) return;
+	sweepPairs[slot->second] = sweepPairs.back();
+	sweepPairSlots[sweepPairs.back()] = slot->second;
+	sweepPairs.pop_back();
+	sweepPairSlots.erase(key);
+}
+
+// Same candidate pairs as spatialHashPairs(), from sweep and prune along x with state kept across frames
+// Entities only move a little per frame, so the insertion sort of the endpoints does few swaps, and every swap of
+// a min and a max endpoint is exactly a pair starting or stopping to overlap along x
+void PhysicsSystem::sweepAndPrunePairs()
 {
-	// Check for collisions between moving entities
 	ComponentContainer<Motion>& motions = registry.motions;
 
-	std::vector<std::vector<vec2>> boundingBoxPolygons;
-	boundingBoxPolygons.reserve(motions.size());
-	for (Entity entity : motions.entities) {
-		Motion& motion = motions.get(entity);
-		boundingBoxPolygons.push_back(getPolygonOfBoundingBox(motion));
+	// Endpoint order along x, a min goes before a max at the same value so that touching extents overlap like in spatialHashPairs()
+	auto sweepBefore = [](const SweepEndpoint& a, const SweepEndpoint& b) {
+		return a.value < b.value || (a.value == b.value && !a.isMax && b.isMax);
+	};
+
+	// Drop the boxes of entities that lost their motion or joined the static layer, and refresh the others
+	bool removed = false;
+	for (unsigned int b = 0; b < sweepBoxes.size(); b++) {
+		SweepBox& box = sweepBoxes[b];
+		if (!box.live) continue;
+		box.motionIndex = motions.index_of(box.entity);
+		if (box.motionIndex == INVALID_COMPONENT_INDEX || motionLayers[box.motionIndex] != DYNAMIC_BODY) {
+			box.live = false;
+			freeSweepBoxes.push_back(b);
+			removed = true;
+		}
+	}
+	if (removed) {
+		sweepEndpoints.erase(std::remove_if(sweepEndpoints.begin(), sweepEndpoints.end(),
+			[&](const SweepEndpoint& endpoint) { return !sweepBoxes[endpoint.box].live; }), sweepEndpoints.end());
+		for (size_t p = sweepPairs.size(); p-- > 0;) {
+			if (!sweepBoxes[sweepPairs[p] >> 32].live || !sweepBoxes[sweepPairs[p] & 0xFFFFFFFF].live)
+				removeSweepPair(sweepPairs[p]);
+		}
+	}
+
+	// New moving bodies get a box, their endpoints start at the end of the list
+	unsigned int added = 0;
+	for (unsigned int i : dynamicMotions) {
+		Entity entity = motions.entities[i];
+		if (entity.index() >= sweepBoxOfSlot.size())
+			sweepBoxOfSlot.resize(entity.index() + 1, INVALID_COMPONENT_INDEX);
+		unsigned int b = sweepBoxOfSlot[entity.index()];
+		if (b < sweepBoxes.size() && sweepBoxes[b].live && sweepBoxes[b].entity == entity) continue;
+		if (freeSweepBoxes.empty()) {
+			b = (unsigned int)sweepBoxes.size();
+			sweepBoxes.emplace_back();
+		}
+		else {
+			b = freeSweepBoxes.back();
+			freeSweepBoxes.pop_back();
+		}
+		sweepBoxes[b] = { entity, i, vec2(0), vec2(0), true };
+		sweepBoxOfSlot[entity.index()] = b;
+		sweepEndpoints.push_back({ 0, b, false });
+		sweepEndpoints.push_back({ 0, b, true });
+		added++;
+	}
+
+	for (SweepBox& box : sweepBoxes) {
+		if (!box.live) continue;
+		bodyExtent(box.motionIndex, box.low, box.high);
+	}
+	for (SweepEndpoint& endpoint : sweepEndpoints) {
+		endpoint.value = endpoint.isMax ? sweepBoxes[endpoint.box].high.x : sweepBoxes[endpoint.box].low.x;
+	}
+
+	if (added > SWEEP_REBUILD_THRESHOLD) {
+		// Sort and sweep: every box overlaps the boxes still open when its min is reached
+		std::sort(sweepEndpoints.begin(), sweepEndpoints.end(), sweepBefore);
+		sweepPairs.clear();
+		sweepPairSlots.clear();
+		sweepActive.clear();
+		for (const SweepEndpoint& endpoint : sweepEndpoints) {
+			if (!endpoint.isMax) {
+				for (unsigned int open : sweepActive)
+					addSweepPair(sweepPairKey(open, endpoint.box));
+				sweepActive.push_back(endpoint.box);
+			}
+			else {
+				*std::find(sweepActive.begin(), sweepActive.end(), endpoint.box) = sweepActive.back();
+				sweepActive.pop_back();
+			}
+		}
+	}
+	else {
+		// Insertion sort, a min passing a max starts an overlap and a max passing a min ends one
+		for (size_t k = 1; k < sweepEndpoints.size(); k++) {
+			SweepEndpoint moving = sweepEndpoints[k];
+			size_t m = k;
+			for (; m > 0 && sweepBefore(moving, sweepEndpoints[m - 1]); m--) {
+				const SweepEndpoint& passed = sweepEndpoints[m - 1];
+				if (!moving.isMax && passed.isMax)
+					addSweepPair(sweepPairKey(moving.box, passed.box));
+				else if (moving.isMax && !passed.isMax)
+					removeSweepPair(sweepPairKey(moving.box, passed.box));
+				sweepEndpoints[m] = passed;
+			}
+			sweepEndpoints[m] = moving;
+		}
+	}
+
+	// The pairs overlapping along x that also overlap along y
+	for (unsigned long long key : sweepPairs) {
+		const SweepBox& a = sweepBoxes[key >> 32];
+		const SweepBox& b = sweepBoxes[key & 0xFFFFFFFF];
+		if (a.low.y <= b.high.y && b.low.y <= a.high.y)
+			candidatePairs.push_back({ min(a.motionIndex, b.motionIndex), max(a.motionIndex, b.motionIndex) });
 	}
+}
+
+// Buckets the extents of the obstacles into a grid just large enough to hold them, and records which entity slots
+// are static or ignored. Obstacles are assumed not to move, a moved one keeps colliding where it was built.
+void PhysicsSystem::rebuildStaticLayer()
+{
+	staticBodies.clear();
+	largeStaticBodies.clear();
+	layerOfSlot.clear();
+	auto setLayer = [&](Entity entity, BODY_LAYER layer) {
+		if (entity.index() >= layerOfSlot.size())
+			layerOfSlot.resize(entity.index() + 1, DYNAMIC_BODY);
+		layerOfSlot[entity.index()] = layer;
+	};
 
-	for (uint i = 0; i < motions.components.size(); i++) {
-		Entity entity_i = motions.entities[i];
-		Motion& motion_i = motions.components[i];
+	// ground tiles never collide with anything, side cliffs are map tiles as well but also obstacles
+	for (Entity entity : registry.mapTiles.entities) {
+		setLayer(entity, IGNORED_BODY);
+	}
+	int gridX1 = INT_MIN, gridY1 = INT_MIN;
+	staticGridX = INT_MAX;
+	staticGridY = INT_MAX;
+	for (Entity entity : registry.obstacles.entities) {
+		if (!registry.motions.has(entity)) continue;
+		setLayer(entity, STATIC_BODY);
+		StaticBody body;
+		body.entity = entity;
+		body.motionIndex = INVALID_COMPONENT_INDEX;
+		groundExtent(registry.motions.get(entity), body.low, body.high);
+		body.x0 = (int)floor(body.low.x / COLLISION_CELL_SIZE);
+		body.y0 = (int)floor(body.low.y / COLLISION_CELL_SIZE);
+		body.x1 = (int)floor(body.high.x / COLLISION_CELL_SIZE);
+		body.y1 = (int)floor(body.high.y / COLLISION_CELL_SIZE);
+		body.large = (long long)(body.x1 - body.x0 + 1) * (body.y1 - body.y0 + 1) > MAX_CELLS_PER_ENTITY;
+		if (body.large) {
+			largeStaticBodies.push_back((unsigned int)staticBodies.size());
+		}
+		else {
+			staticGridX = min(staticGridX, body.x0);
+			staticGridY = min(staticGridY, body.y0);
+			gridX1 = max(gridX1, body.x1);
+			gridY1 = max(gridY1, body.y1);
+		}
+		staticBodies.push_back(body);
+	}
+	bool gridEmpty = staticBodies.size() == largeStaticBodies.size();
+	staticGridWidth = gridEmpty ? 0 : gridX1 - staticGridX + 1;
+	staticGridHeight = gridEmpty ? 0 : gridY1 - staticGridY + 1;
+
+	// Counting sort of the bodies into their cells, cell c holds staticCellBodies[staticCellStarts[c], staticCellStarts[c + 1])
+	staticCellStarts.assign(staticGridWidth * staticGridHeight + 1, 0);
+	auto forEachCell = [&](const StaticBody& body, auto fn) {
+		for (int y = body.y0; y <= body.y1; y++)
+			for (int x = body.x0; x <= body.x1; x++)
+				fn((y - staticGridY) * staticGridWidth + (x - staticGridX));
+	};
+	for (unsigned int b = 0; b < staticBodies.size(); b++) {
+		if (staticBodies[b].large) continue;
+		forEachCell(staticBodies[b], [&](unsigned int cell) { staticCellStarts[cell + 1]++; });
+	}
+	for (size_t c = 1; c < staticCellStarts.size(); c++) {
+		staticCellStarts[c] += staticCellStarts[c - 1];
+	}
+	std::vector<unsigned int> cursors(staticCellStarts.begin(), staticCellStarts.end() - 1);
+	staticCellBodies.resize(staticCellStarts.back());
+	for (unsigned int b = 0; b < staticBodies.size(); b++) {
+		if (staticBodies[b].large) continue;
+		forEachCell(staticBodies[b], [&](unsigned int cell) { staticCellBodies[cursors[cell]++] = b; });
+	}
+	staticLayerDirty = false;
+}
 
-		for (uint j = i + 1; j < motions.components.size(); j++) {
-			Entity entity_j = motions.entities[j];
-			Motion& motion_j = motions.components[j];
+// Sorts this frame's motions into the moving bodies, the static layer and the ignored map tiles
+void PhysicsSystem::assignLayers()
+{
+	if (staticLayerDirty) {
+		rebuildStaticLayer();
+	}
+	ComponentContainer<Motion>& motions = registry.motions;
+	motionLayers.resize(motions.size());
+	dynamicMotions.clear();
+	for (unsigned int i = 0; i < motions.size(); i++) {
+		unsigned int slot = motions.entities[i].index();
+		motionLayers[i] = slot < layerOfSlot.size() ? layerOfSlot[slot] : DYNAMIC_BODY;
+		if (motionLayers[i] == DYNAMIC_BODY) {
+			dynamicMotions.push_back(i);
+		}
+	}
+	// dense indices move when motions are removed
+	for (StaticBody& body : staticBodies) {
+		body.motionIndex = motions.index_of(body.entity);
+	}
 
-			// skip obstacle to obstacle collision
-			if (registry.obstacles.has(entity_i) && registry.obstacles.has(entity_j)) continue;
+	// only moving bodies that actually moved are swept
+	sweptBodyOfMotion.assign(motions.size(), INVALID_COMPONENT_INDEX);
+	size_t kept = 0;
+	for (SweptBody& body : sweptBodies) {
+		body.motionIndex = motions.index_of(body.entity);
+		if (body.motionIndex == INVALID_COMPONENT_INDEX || motionLayers[body.motionIndex] != DYNAMIC_BODY) continue;
+		if (motions.components[body.motionIndex].position == body.start) continue;
+		sweptBodyOfMotion[body.motionIndex] = (unsigned int)kept;
+		sweptBodies[kept++] = body;
+	}
+	sweptBodies.resize(kept);
+}
 
-			if (collides(motion_i, motion_j, boundingBoxPolygons.at(i), boundingBoxPolygons.at(j))) {
-				if (registry.meshPtrs.has(entity_i)) {
-					if (meshCollides(entity_i, entity_j)) {
-						handle_mesh_collision(entity_i, entity_j);
-						collisions.push_back(std::make_pair(entity_i, entity_j));
-						collisions.push_back(std::make_pair(entity_j, entity_i));
-					}
+// The ground extent of the motion at i, stretched back to where it started the step if it is swept
+void PhysicsSystem::bodyExtent(unsigned int i, vec2& low, vec2& high) const
+{
+	const Motion& motion = registry.motions.components[i];
+	groundExtent(motion, low, high);
+	unsigned int swept = sweptBodyOfMotion[i];
+	if (swept != INVALID_COMPONENT_INDEX) {
+		vec2 back = vec2(sweptBodies[swept].start) - vec2(motion.position);
+		low = min(low, low + back);
+		high = max(high, high + back);
+	}
+}
+
+// Appends the pairs of a moving body and a static one whose extents overlap, each moving body looks up the cells it covers
+void PhysicsSystem::staticLayerPairs()
+{
+	for (unsigned int i : dynamicMotions) {
+		vec2 low, high;
+		bodyExtent(i, low, high);
+		auto overlaps = [&](const StaticBody& body) {
+			return body.motionIndex != INVALID_COMPONENT_INDEX
+				&& low.x <= body.high.x && body.low.x <= high.x && low.y <= body.high.y && body.low.y <= high.y;
+		};
+
+		for (unsigned int b : largeStaticBodies) {
+			const StaticBody& body = staticBodies[b];
+			if (overlaps(body)) {
+				candidatePairs.push_back({ min(i, body.motionIndex), max(i, body.motionIndex) });
+			}
+		}
+		if (staticGridWidth == 0) continue;
+
+		// only the cells of the grid, the static bodies are all inside it
+		int x0 = max((int)floor(low.x / COLLISION_CELL_SIZE), staticGridX);
+		int y0 = max((int)floor(low.y / COLLISION_CELL_SIZE), staticGridY);
+		int x1 = min((int)floor(high.x / COLLISION_CELL_SIZE), staticGridX + staticGridWidth - 1);
+		int y1 = min((int)floor(high.y / COLLISION_CELL_SIZE), staticGridY + staticGridHeight - 1);
+		for (int y = y0; y <= y1; y++) {
+			for (int x = x0; x <= x1; x++) {
+				unsigned int cell = (y - staticGridY) * staticGridWidth + (x - staticGridX);
+				for (unsigned int k = staticCellStarts[cell]; k < staticCellStarts[cell + 1]; k++) {
+					const StaticBody& body = staticBodies[staticCellBodies[k]];
+					// a body covering several of these cells is only taken from the one holding the low corner of the overlap
+					if (max(body.x0, x0) != x || max(body.y0, y0) != y || !overlaps(body)) continue;
+					candidatePairs.push_back({ min(i, body.motionIndex), max(i, body.motionIndex) });
 				}
-				else if (registry.meshPtrs.has(entity_j)) {
-					if (meshCollides(entity_j, entity_i)) {
-						handle_mesh_collision(entity_j, entity_i);
-						collisions.push_back(std::make_pair(entity_i, entity_j));
-						collisions.push_back(std::make_pair(entity_j, entity_i));
-					}
+			}
+		}
+	}
+}
+
+std::vector<Entity> PhysicsSystem::obstaclesNear(vec2 centre, float radius)
+{
+	if (staticLayerDirty) {
+		rebuildStaticLayer();
+	}
+	vec2 low = centre - vec2(radius);
+	vec2 high = centre + vec2(radius);
+	auto overlaps = [&](const StaticBody& body) {
+		return low.x <= body.high.x && body.low.x <= high.x && low.y <= body.high.y && body.low.y <= high.y;
+	};
+
+	std::vector<Entity> nearby;
+	for (unsigned int b : largeStaticBodies) {
+		if (overlaps(staticBodies[b])) {
+			nearby.push_back(staticBodies[b].entity);
+		}
+	}
+	if (staticGridWidth == 0) {
+		return nearby;
+	}
+	int x0 = max((int)floor(low.x / COLLISION_CELL_SIZE), staticGridX);
+	int y0 = max((int)floor(low.y / COLLISION_CELL_SIZE), staticGridY);
+	int x1 = min((int)floor(high.x / COLLISION_CELL_SIZE), staticGridX + staticGridWidth - 1);
+	int y1 = min((int)floor(high.y / COLLISION_CELL_SIZE), staticGridY + staticGridHeight - 1);
+	for (int y = y0; y <= y1; y++) {
+		for (int x = x0; x <= x1; x++) {
+			unsigned int cell = (y - staticGridY) * staticGridWidth + (x - staticGridX);
+			for (unsigned int k = staticCellStarts[cell]; k < staticCellStarts[cell + 1]; k++) {
+				const StaticBody& body = staticBodies[staticCellBodies[k]];
+				// same as in staticLayerPairs(), a body is only taken from the cell holding the low corner of the overlap
+				if (max(body.x0, x0) != x || max(body.y0, y0) != y || !overlaps(body)) continue;
+				nearby.push_back(body.entity);
+			}
+		}
+	}
+	return nearby;
+}
+
+void PhysicsSystem::setBroadphase(BROADPHASE mode)
+{
+	if (collisionCheckFrames > 0) {
+		printf("Broadphase %s: %.3f ms per collision check over %u frames\n", broadphase_names[(int)broadphase],
+			collisionCheckMs / collisionCheckFrames, collisionCheckFrames);
+	}
+	broadphase = mode;
+	collisionCheckMs = 0;
+	collisionCheckFrames = 0;
+
+	// the sweep state is stale once other broadphases ran, it is rebuilt on the next use
+	sweepBoxes.clear();
+	freeSweepBoxes.clear();
+	sweepEndpoints.clear();
+	sweepPairs.clear();
+	sweepPairSlots.clear();
+	printf("Broadphase switched to %s\n", broadphase_names[(int)broadphase]);
+}
+
+// How far into a body a swept one is placed at its time of impact, so the narrow phase sees them touch despite rounding
+const float SWEEP_CONTACT_DEPTH = 0.5f;
+
+// Earliest fraction of the step at which the box of moving, travelling from start by step, touches the box of other
+// The boxes are the extents collides() checks before the polygons, other is taken where it ended the step.
+// False when they do not meet during the step, or already overlap at its start and are left to the discrete test.
+static bool timeOfImpact(vec3 start, vec3 step, const Motion& moving, const Motion& other, float& time)
+{
+	vec3 half = vec3(max(moving.hitbox.x, moving.hitbox.z) + max(other.hitbox.x, other.hitbox.z),
+		moving.hitbox.y + other.hitbox.y,
+		max(moving.hitbox.x, moving.hitbox.z) + max(other.hitbox.x, other.hitbox.z)) / 2.f;
+	vec3 gap = other.position - start;
+	float enter = -FLT_MAX;
+	float exit = FLT_MAX;
+	for (int k = 0; k < 3; k++) {
+		if (step[k] == 0) {
+			if (abs(gap[k]) > half[k]) return false;
+			continue;
+		}
+		float t1 = (gap[k] - half[k]) / step[k];
+		float t2 = (gap[k] + half[k]) / step[k];
+		enter = max(enter, min(t1, t2));
+		exit = min(exit, max(t1, t2));
+	}
+	if (enter > exit || enter <= 0 || enter > 1) return false;
+	time = enter;
+	return true;
+}
+
+// Continuous collision for projectiles and damagings: one that would pass through a solid body during a long step is
+// moved back to where it first touched it, so the narrow phase finds the hit however far it travelled
+// Bodies are swept against where the others ended the step, pairs of two swept bodies are left to the discrete test.
+void PhysicsSystem::sweepProjectiles()
+{
+	if (sweptBodies.empty()) return;
+	ComponentContainer<Motion>& motions = registry.motions;
+
+	sweptHits.clear();
+	auto sweep = [&](unsigned int i, unsigned int other) {
+		if (sweptBodyOfMotion[i] == INVALID_COMPONENT_INDEX || sweptBodyOfMotion[other] != INVALID_COMPONENT_INDEX) return;
+		if (!motions.components[other].solid) return;
+		Entity entity = motions.entities[i];
+		if (registry.damagings.has(entity) && registry.damagings.get(entity).excludedEntity == motions.entities[other]) return;
+		const SweptBody& body = sweptBodies[sweptBodyOfMotion[i]];
+		const Motion& motion = motions.components[i];
+		float time;
+		if (timeOfImpact(body.start, motion.position - body.start, motion, motions.components[other], time))
+			sweptHits.push_back({ sweptBodyOfMotion[i], time, other });
+	};
+	for (const std::pair<unsigned int, unsigned int>& pair : candidatePairs) {
+		sweep(pair.first, pair.second);
+		sweep(pair.second, pair.first);
+	}
+	std::sort(sweptHits.begin(), sweptHits.end(), [](const SweptHit& a, const SweptHit& b) {
+		return a.body < b.body || (a.body == b.body && a.time < b.time);
+	});
+
+	// Per swept body, the earliest hit that the full test confirms, the boxes are only a bound of the shapes
+	for (size_t h = 0; h < sweptHits.size();) {
+		unsigned int b = sweptHits[h].body;
+		const SweptBody& body = sweptBodies[b];
+		Motion& motion = motions.components[body.motionIndex];
+		vec3 end = motion.position;
+		vec3 step = end - body.start;
+		float depth = SWEEP_CONTACT_DEPTH / length(step);
+		bool hit = false;
+		for (; h < sweptHits.size() && sweptHits[h].body == b; h++) {
+			if (hit) continue;
+			motion.position = body.start + step * min(1.f, sweptHits[h].time + depth);
+			boundingBoxPolygons[body.motionIndex] = getPolygonOfBoundingBox(motion);
+			if (pairOverlaps(body.motionIndex, sweptHits[h].other)) {
+				impacts.push_back({ body.entity, motions.entities[sweptHits[h].other], sweptHits[h].time });
+				hit = true;
+			}
+		}
+		if (!hit) {
+			motion.position = end;
+			boundingBoxPolygons[body.motionIndex] = getPolygonOfBoundingBox(motion);
+		}
+	}
+}
+
+// Whether the motions at i and j overlap, down to the triangles if one of them has a mesh
+bool PhysicsSystem::pairOverlaps(unsigned int i, unsigned int j)
+{
+	ComponentContainer<Motion>& motions = registry.motions;
+	Entity entity_i = motions.entities[i];
+	Entity entity_j = motions.entities[j];
+	if (!collides(motions.components[i], motions.components[j], boundingBoxPolygons.at(i), boundingBoxPolygons.at(j))) {
+		return false;
+	}
+	if (registry.meshPtrs.has(entity_i)) {
+		return meshCollides(entity_i, entity_j);
+	}
+	if (registry.meshPtrs.has(entity_j)) {
+		return meshCollides(entity_j, entity_i);
+	}
+	return true;
+}
+
+// The full test of the motions at i and j, recording a collision and resolving it
+void PhysicsSystem::testPair(unsigned int i, unsigned int j)
+{
+	ComponentContainer<Motion>& motions = registry.motions;
+	Entity entity_i = motions.entities[i];
+	Motion& motion_i = motions.components[i];
+	Entity entity_j = motions.entities[j];
+	Motion& motion_j = motions.components[j];
+
+	if (collides(motion_i, motion_j, boundingBoxPolygons.at(i), boundingBoxPolygons.at(j))) {
+		if (registry.meshPtrs.has(entity_i)) {
+			if (meshCollides(entity_i, entity_j)) {
+				handle_mesh_collision(entity_i, entity_j);
+				collisions.push_back(std::make_pair(entity_i, entity_j));
+				collisions.push_back(std::make_pair(entity_j, entity_i));
+			}
+		}
+		else if (registry.meshPtrs.has(entity_j)) {
+			if (meshCollides(entity_j, entity_i)) {
+				handle_mesh_collision(entity_j, entity_i);
+				collisions.push_back(std::make_pair(entity_i, entity_j));
+				collisions.push_back(std::make_pair(entity_j, entity_i));
+			}
+		}
+		else {
+			// Collision detected
+			collisions.push_back(std::make_pair(entity_i, entity_j));
+			collisions.push_back(std::make_pair(entity_j, entity_i));
+
+			// Push each other
+			if (motions.components[i].solid && motions.components[j].solid) {
+				if (registry.obstacles.has(entity_i)) { //obstacle collision
+					handle_obstacle_collision(entity_i, entity_j);
+				}
+				else if (registry.obstacles.has(entity_j)) {
+					handle_obstacle_collision(entity_j, entity_i);
 				}
 				else {
-					// Collision detected
-					collisions.push_back(std::make_pair(entity_i, entity_j));
-					collisions.push_back(std::make_pair(entity_j, entity_i));
-
-					// Push each other
-					if (motions.components[i].solid && motions.components[j].solid) {
-						if (registry.obstacles.has(entity_i)) { //obstacle collision
-							handle_obstacle_collision(entity_i, entity_j);
-						}
-						else if (registry.obstacles.has(entity_j)) {
-							handle_obstacle_collision(entity_j, entity_i);
-						}
-						else {
-							recoil_entities(entity_i, entity_j);
-						}
-					}
+					recoil_entities(entity_i, entity_j);
 				}
 			}
 		}
 	}
 }
 
+void PhysicsSystem::checkCollisions()
+{
+	// Check for collisions between moving entities
+	ComponentContainer<Motion>& motions = registry.motions;
+
+	boundingBoxPolygons.resize(motions.size());
+	for (size_t i = 0; i < motions.size(); i++) {
+		boundingBoxPolygons[i] = getPolygonOfBoundingBox(motions.components[i]);
+	}
+
+	assignLayers();
+	impacts.clear();
+
+	if (broadphase == BROADPHASE::BRUTE_FORCE) {
+		// the sweep looks at every pair with a swept body
+		candidatePairs.clear();
+		for (const SweptBody& body : sweptBodies) {
+			for (uint j = 0; j < motions.components.size(); j++) {
+				if (j != body.motionIndex && motionLayers[j] != IGNORED_BODY)
+					candidatePairs.push_back({ min(body.motionIndex, j), max(body.motionIndex, j) });
+			}
+		}
+		sweepProjectiles();
+		sweptBodies.clear();
+
+		for (uint i = 0; i < motions.components.size(); i++) {
+			for (uint j = i + 1; j < motions.components.size(); j++) {
+				// same pairs as the other broadphases: no map tiles, no obstacle against obstacle
+				if (motionLayers[i] == IGNORED_BODY || motionLayers[j] == IGNORED_BODY) continue;
+				if (motionLayers[i] == STATIC_BODY && motionLayers[j] == STATIC_BODY) continue;
+				testPair(i, j);
+			}
+		}
+		return;
+	}
+
+	candidatePairs.clear();
+	if (broadphase == BROADPHASE::SWEEP_AND_PRUNE) {
+		sweepAndPrunePairs();
+	}
+	else {
+		spatialHashPairs();
+	}
+	staticLayerPairs();
+	// the narrow phase visits the pairs in the same order as a loop over all pairs would
+	std::sort(candidatePairs.begin(), candidatePairs.end());
+	sweepProjectiles();
+	sweptBodies.clear();
+	for (const std::pair<unsigned int, unsigned int>& pair : candidatePairs) {
+		// a fireball destroyed by a mesh hit swaps the last motion into its place
+		if (pair.second >= motions.size()) continue;
+		testPair(pair.first, pair.second);
+	}
+}
+
 static vec3 tranformVertex(vec3 vertex, vec3 translation, float rotation, vec3 scaling)
 {
 	// Scaling
@@ -155,10 +738,52 @@ static vec3 tranformVertex(vec3 vertex, vec3 translation, float rotation, vec3 s
 	return rotatedVertex;
 }
 
+SatPolygon satQuad(vec2 a, vec2 b, vec2 c, vec2 d)
+{
+	return { vec4(a.x, b.x, c.x, d.x), vec4(a.y, b.y, c.y, d.y) };
+}
+
+SatPolygon satTriangle(vec2 a, vec2 b, vec2 c)
+{
+	return { vec4(a.x, b.x, c.x, c.x), vec4(a.y, b.y, c.y, c.y) };
+}
+
+// Projects both polygons onto four axes at once, one axis per lane, and checks for a gap on any of them
+static bool separatedOnAxes(const SatPolygon& polygon1, const SatPolygon& polygon2, vec4 axisX, vec4 axisY)
+{
+	vec4 min1 = axisX * polygon1.x[0] + axisY * polygon1.y[0];
+	vec4 max1 = min1;
+	vec4 min2 = axisX * polygon2.x[0] + axisY * polygon2.y[0];
+	vec4 max2 = min2;
+	for (int v = 1; v < 4; v++) {
+		vec4 projected1 = axisX * polygon1.x[v] + axisY * polygon1.y[v];
+		vec4 projected2 = axisX * polygon2.x[v] + axisY * polygon2.y[v];
+		min1 = min(min1, projected1);
+		max1 = max(max1, projected1);
+		min2 = min(min2, projected2);
+		max2 = max(max2, projected2);
+	}
+	return any(lessThan(max1, min2)) || any(lessThan(max2, min1));
+}
+
+// Same result as polygonsCollide for convex polygons of 3 or 4 vertices, without allocating
+bool satCollide(const SatPolygon& polygon1, const SatPolygon& polygon2)
+{
+	// Edge normals {p2.y - p1.y, p1.x - p2.x}, edge i runs from vertex i to vertex i + 1
+	vec4 next1X = vec4(polygon1.x.y, polygon1.x.z, polygon1.x.w, polygon1.x.x);
+	vec4 next1Y = vec4(polygon1.y.y, polygon1.y.z, polygon1.y.w, polygon1.y.x);
+	if (separatedOnAxes(polygon1, polygon2, next1Y - polygon1.y, polygon1.x - next1X)) {
+		return false;
+	}
+	vec4 next2X = vec4(polygon2.x.y, polygon2.x.z, polygon2.x.w, polygon2.x.x);
+	vec4 next2Y = vec4(polygon2.y.y, polygon2.y.z, polygon2.y.w, polygon2.y.x);
+	return !separatedOnAxes(polygon1, polygon2, next2Y - polygon2.y, polygon2.x - next2X);
+}
+
 bool polygonsCollide(const std::vector<vec2>& polygon1, const std::vector<vec2>& polygon2) {
 	// Check if two polygons are intersecting
 	for (int i = 0; i < 2; i++) {
-		std::vector<vec2> polygon = i == 0 ? polygon1 : polygon2;
+		const std::vector<vec2>& polygon = i == 0 ? polygon1 : polygon2;
 		for (int i1 = 0; i1 < polygon.size(); i1++) {
 			int i2 = (i1 + 1) % polygon.size();
 			vec2 p1 = polygon[i1];
@@ -191,11 +816,8 @@ bool polygonsCollide(const std::vector<vec2>& polygon1, const std::vector<vec2>&
 }
 
 bool PhysicsSystem::meshCollides(Entity& mesh_entity, Entity& other_entity) {
-	Mesh& mesh = *(registry.meshPtrs.get(mesh_entity));
 	Motion& mesh_motion = registry.motions.get(mesh_entity);
 	Motion& other_motion = registry.motions.get(other_entity);
-	// Polygon vertices
-	std::vector<vec2> otherPolygon;
 	float halfWidth = other_motion.hitbox.x / 2;
 	float halfDepth = other_motion.hitbox.y / 2;
 	float halfHeight = other_motion.hitbox.z / 2;
@@ -232,108 +854,220 @@ bool PhysicsSystem::meshCollides(Entity& mesh_entity, Entity& other_entity) {
 			}
 		}
 	}
-	otherPolygon.push_back({ minHorizontalPos, minVerticalPos });
-	otherPolygon.push_back({ maxHorizontalPos, minVerticalPos });
-	otherPolygon.push_back({ maxHorizontalPos, maxVerticalPos });
-	otherPolygon.push_back({ minHorizontalPos, maxVerticalPos });
+	SatPolygon otherPolygon = satQuad(
+		{ minHorizontalPos, minVerticalPos },
+		{ maxHorizontalPos, minVerticalPos },
+		{ maxHorizontalPos, maxVerticalPos },
+		{ minHorizontalPos, maxVerticalPos });
+
+	// Only the triangles in tree nodes overlapping the other entity's box
+	const MeshCollider& collider = meshCollider(mesh_entity);
+	auto outside = [&](vec2 low, vec2 high) {
+		return low.x > maxHorizontalPos || high.x < minHorizontalPos || low.y > maxVerticalPos || high.y < minVerticalPos;
+	};
+	for (unsigned int n = 0; n < collider.nodes.size();) {
+		const MeshTreeNode& node = collider.nodes[n];
+		if (outside(node.low, node.high)) {
+			n = node.skip;
+			continue;
+		}
+		for (unsigned int t = node.first; t < node.first + node.count; t++) {
+			const MeshTriangle& triangle = collider.triangles[t];
+			if (!outside(triangle.low, triangle.high) && satCollide(triangle.polygon, otherPolygon)) {
+				return true;
+			}
+		}
+		n++;
+	}
+	return false;
+}
 
-	std::vector<uint16_t>& faces = mesh.vertex_indices;
-	for (int i = 0; i < faces.size(); i += 3) {
-		std::vector<vec2> meshPolygon;
+// Triangles per leaf of a mesh's AABB tree
+const unsigned int MESH_TREE_LEAF_SIZE = 4;
 
-		vec3 collisionVertex;
-		// Get the vertices of the face
+// The cached triangles of a mesh entity, transformed again only when its angle or scale changed
+const PhysicsSystem::MeshCollider& PhysicsSystem::meshCollider(Entity mesh_entity)
+{
+	const Mesh* mesh = registry.meshPtrs.get(mesh_entity);
+	const Motion& mesh_motion = registry.motions.get(mesh_entity);
+	MeshCollider& collider = meshColliders[mesh_entity.index()];
+	if (collider.entity == mesh_entity && collider.mesh == mesh && collider.angle == mesh_motion.angle && collider.scale == mesh_motion.scale) {
+		return collider;
+	}
+	collider.entity = mesh_entity;
+	collider.mesh = mesh;
+	collider.angle = mesh_motion.angle;
+	collider.scale = mesh_motion.scale;
+
+	// Faces flattened into the plane of the horizontal position and the height relative to the mesh
+	const std::vector<uint16_t>& faces = mesh->vertex_indices;
+	vec3 scaling = { mesh_motion.scale.x, 0, mesh_motion.scale.y / zConversionFactor };
+	collider.triangles.resize(faces.size() / 3);
+	for (size_t i = 0; i + 2 < faces.size(); i += 3) {
+		std::array<vec2, 3> face;
 		for (int j = 0; j < 3; j++) {
-			vec2 v = mesh.vertices[faces[i + j]].position;
+			vec2 v = mesh->vertices[faces[i + j]].position;
 			vec3 vertex = { v.x, 0, -v.y };
-			vec3 scaling = { mesh_motion.scale.x, 0, mesh_motion.scale.y / zConversionFactor };
-			vec3 translation = vec3(0);
-			vertex = tranformVertex(vertex, translation, mesh_motion.angle, scaling);
-			meshPolygon.push_back({ vertex.x, vertex.z });
+			vertex = tranformVertex(vertex, vec3(0), mesh_motion.angle, scaling);
+			face[j] = { vertex.x, vertex.z };
 		}
+		MeshTriangle& triangle = collider.triangles[i / 3];
+		triangle.polygon = satTriangle(face[0], face[1], face[2]);
+		triangle.low = min(min(face[0], face[1]), face[2]);
+		triangle.high = max(max(face[0], face[1]), face[2]);
+	}
 
-		// Check if the transformed vertices are within the bounding box
-		if (polygonsCollide(meshPolygon, otherPolygon)) {
-			return true;
-		}
+	collider.nodes.clear();
+	if (!collider.triangles.empty()) {
+		buildMeshTree(collider, 0, (unsigned int)collider.triangles.size());
 	}
-	return false;
+	return collider;
 }
 
-void PhysicsSystem::updatePositions(float elapsed_ms)
+// Appends the subtree over triangles [first, first + count), split at the median centre along the longer side of their bounds
+void PhysicsSystem::buildMeshTree(MeshCollider& collider, unsigned int first, unsigned int count)
 {
-	for (Entity entity : registry.motions.entities) {
-		if(registry.explosions.has(entity)) {
-			// don't need to update explosion position
-			continue;
-		}
+	unsigned int index = (unsigned int)collider.nodes.size();
+	collider.nodes.emplace_back();
+	vec2 low = vec2(FLT_MAX);
+	vec2 high = vec2(-FLT_MAX);
+	for (unsigned int t = first; t < first + count; t++) {
+		low = min(low, collider.triangles[t].low);
+		high = max(high, collider.triangles[t].high);
+	}
+	if (count <= MESH_TREE_LEAF_SIZE) {
+		collider.nodes[index] = { low, high, first, count, index + 1 };
+		return;
+	}
 
-		Motion& motion = registry.motions.get(entity);
+	int axis = high.x - low.x >= high.y - low.y ? 0 : 1;
+	auto begin = collider.triangles.begin() + first;
+	std::nth_element(begin, begin + count / 2, begin + count, [axis](const MeshTriangle& a, const MeshTriangle& b) {
+		return a.low[axis] + a.high[axis] < b.low[axis] + b.high[axis];
+	});
+	buildMeshTree(collider, first, count / 2);
+	buildMeshTree(collider, first + count / 2, count - count / 2);
+	collider.nodes[index] = { low, high, first, 0, (unsigned int)collider.nodes.size() };
+}
 
+void PhysicsSystem::updatePositions(float elapsed_ms)
+{
+	// Set player velocity
+	registry.view<Player, Motion>().each([&](Entity entity, Player& player_comp, Motion& motion) {
 		// Z-position of entity when it is on the ground
 		float groundZ = getElevation(vec2(motion.position)) + motion.hitbox.z / 2;
+		if (motion.position.z > groundZ) {
+			return;
+		}
 
-		// Set player velocity
-		if (registry.players.has(entity) && motion.position.z <= groundZ) {
-			Player& player_comp = registry.players.get(entity);
+		float player_speed = motion.speed;
+		if (!player_comp.isMoving) player_speed = 0;
+		else if (player_comp.isRunning) player_speed *= 2;
 
-			float player_speed = motion.speed;
-			if (!player_comp.isMoving) player_speed = 0;
-			else if (player_comp.isRunning) player_speed *= 2;
+		motion.velocity.x = (player_speed * motion.facing).x;
+		motion.velocity.y = (player_speed * motion.facing).y;
+	});
 
-			motion.velocity.x = (player_speed * motion.facing).x;
-			motion.velocity.y = (player_speed * motion.facing).y;
+	// Per-entity factors for the integration kernel, only the few special cases are written individually
+	ComponentContainer<Motion>& motion_container = registry.motions;
+	size_t count = motion_container.size();
+	groundZs.resize(count);
+	moveFactors.assign(count, 1.f);
+	gravityFactors.assign(count, 1.f);
+
+	// explosions don't need their position updated
+	for (Entity entity : registry.explosions.entities) {
+		unsigned int i = motion_container.index_of(entity);
+		if (i != INVALID_COMPONENT_INDEX) {
+			moveFactors[i] = 0.f;
+			gravityFactors[i] = 0.f;
 		}
+	}
 
-		// Update the entity's position based on its velocity and elapsed time
-		motion.position.x += motion.velocity.x * elapsed_ms;
-		motion.position.y += motion.velocity.y * elapsed_ms;
-		motion.position.z += motion.velocity.z * elapsed_ms;
-
-		// Apply gravity if above the ground
-		if (motion.position.z > groundZ) {
-			// Don't apply gravity to fireballs
-			if (registry.damagings.has(entity) && registry.damagings.get(entity).type == "fireball")
-			{ 
-				continue;
+	// Don't apply gravity to fireballs
+	for (uint d = 0; d < registry.damagings.size(); d++) {
+		if (registry.damagings.components[d].type == DAMAGING_TYPE::FIREBALL) {
+			unsigned int i = motion_container.index_of(registry.damagings.entities[d]);
+			if (i != INVALID_COMPONENT_INDEX) {
+				gravityFactors[i] = 0.f;
 			}
-			motion.velocity.z -= motion.gravity * GRAVITATIONAL_CONSTANT * elapsed_ms;
 		}
+	}
+
+	// Where projectiles and damagings start the step, they are swept from there in checkCollisions()
+	sweptBodies.clear();
+	for (Entity entity : registry.projectiles.entities) {
+		unsigned int i = motion_container.index_of(entity);
+		if (i != INVALID_COMPONENT_INDEX) {
+			sweptBodies.push_back({ entity, i, motion_container.components[i].position });
+		}
+	}
+	for (Entity entity : registry.damagings.entities) {
+		unsigned int i = motion_container.index_of(entity);
+		if (i != INVALID_COMPONENT_INDEX && !registry.projectiles.has(entity)) {
+			sweptBodies.push_back({ entity, i, motion_container.components[i].position });
+		}
+	}
+
+	// Integration kernel: a branch-free pass over the dense Motion array, split across the worker pool
+	// It needs the dense index for the factor arrays, so it runs on index ranges rather than par_for_each
+	parallel_for(count, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			Motion& motion = motion_container.components[i];
+
+			// Z-position of the entity when it is on the ground
+			groundZs[i] = getElevation(vec2(motion.position)) + motion.hitbox.z / 2;
+
+			// Update the entity's position based on its velocity and elapsed time
+			motion.position += motion.velocity * (elapsed_ms * moveFactors[i]);
+
+			// Apply gravity if above the ground
+			float airborne = motion.position.z > groundZs[i] ? 1.f : 0.f;
+			motion.velocity.z -= airborne * gravityFactors[i] * motion.gravity * GRAVITATIONAL_CONSTANT * elapsed_ms;
+		}
+	});
+
+	// Ground contact, only entities on or below the ground take the branchy path
+	for (size_t i = count; i-- > 0;) {
+		Motion& motion = motion_container.components[i];
+		float groundZ = groundZs[i];
+		if (moveFactors[i] == 0.f || motion.position.z > groundZ) {
+			continue;
+		}
+		Entity entity = motion_container.entities[i];
 
 		// Can jump if on the ground
-		if (motion.position.z <= groundZ) {
-			if (registry.jumpers.has(entity)) {
-				Jumper& jumper = registry.jumpers.get(entity);
-				if (registry.players.has(entity)) {
-					Player& player = registry.players.get(entity);
-					Stamina& stamina = registry.staminas.get(entity);
-					if (player.tryingToJump && stamina.stamina > JUMP_STAMINA && !registry.trappables.get(entity).isTrapped) {
-						stamina.stamina -= JUMP_STAMINA;
-						motion.velocity.z = jumper.speed;
-						jumper.isJumping = true;
-						sound->playSoundEffect(Sound::JUMPING, 0);
-					}
-					else {
-						jumper.isJumping = false;
-					}
+		if (registry.jumpers.has(entity)) {
+			Jumper& jumper = registry.jumpers.get(entity);
+			if (registry.players.has(entity)) {
+				Player& player = registry.players.get(entity);
+				Stamina& stamina = registry.staminas.get(entity);
+				if (player.tryingToJump && stamina.stamina > JUMP_STAMINA && !registry.trappables.get(entity).isTrapped) {
+					stamina.stamina -= JUMP_STAMINA;
+					motion.velocity.z = jumper.speed;
+					jumper.isJumping = true;
+					sound->playSoundEffect(Sound::JUMPING, 0);
 				}
 				else {
-					motion.velocity.z = jumper.speed;
+					jumper.isJumping = false;
 				}
 			}
+			else {
+				motion.velocity.z = jumper.speed;
+			}
 		}
 
 		// Hit the ground
 		if (motion.position.z < groundZ && motion.velocity.z <= 0.0f) {
 			if (registry.bounceables.has(entity) && registry.bounceables.get(entity).numBounces > 0) {
 				// Apply upward velocity for bounce, reduced by a decay factor
-    	  motion.velocity.x *= FRICTION_FACTOR;
-    		motion.velocity.y *= FRICTION_FACTOR;
-    		motion.velocity.z = -motion.velocity.z * BOUNCE_FACTOR;
-	
+				motion.velocity.x *= FRICTION_FACTOR;
+				motion.velocity.y *= FRICTION_FACTOR;
+				motion.velocity.z = -motion.velocity.z * BOUNCE_FACTOR;
+
 				registry.bounceables.get(entity).numBounces -= 1;
 				continue;
-      }
+			}
 
 			motion.position.z = groundZ;
 			motion.velocity.z = 0;
@@ -360,29 +1094,28 @@ void PhysicsSystem::updatePositions(float elapsed_ms)
 				motion.velocity = { 0, 0, 0 };
 			}
 		}
+	}
 
-		// Dashing overwrites normal movement
-		if (registry.dashers.has(entity)) {
-			Dash& dashing = registry.dashers.get(entity);
-			if (dashing.isDashing) {
-				dashing.dashTimer += elapsed_ms / 1000.0f; // Converting ms to seconds
+	// Dashing overwrites normal movement
+	registry.view<Dash, Motion>(exclude<Explosion>).each([&](Entity entity, Dash& dashing, Motion& motion) {
+		if (dashing.isDashing) {
+			dashing.dashTimer += elapsed_ms / 1000.0f; // Converting ms to seconds
 
-				if (dashing.dashTimer < dashing.dashDuration) {
-					// Interpolation factor
-					float t = dashing.dashTimer / dashing.dashDuration;
+			if (dashing.dashTimer < dashing.dashDuration) {
+				// Interpolation factor
+				float t = dashing.dashTimer / dashing.dashDuration;
 
-					// Interpolate between start and target positions
-					//player_motion.position is the target_position for the linear interpolation formula L(t)=(1−t)⋅A+t⋅B
-					// L(t) = interpolated position, A = original position, B = target position, and t is the interpolation factor
-					motion.position = vec3(glm::mix(dashing.dashStartPosition, dashing.dashTargetPosition, t), motion.position.z);
-				}
-				else {
-					motion.position = vec3(dashing.dashTargetPosition, motion.position.z);
-					dashing.isDashing = false; // Reset isDashing
-				}
+				// Interpolate between start and target positions
+				//player_motion.position is the target_position for the linear interpolation formula L(t)=(1−t)⋅A+t⋅B
+				// L(t) = interpolated position, A = original position, B = target position, and t is the interpolation factor
+				motion.position = vec3(glm::mix(dashing.dashStartPosition, dashing.dashTargetPosition, t), motion.position.z);
+			}
+			else {
+				motion.position = vec3(dashing.dashTargetPosition, motion.position.z);
+				dashing.isDashing = false; // Reset isDashing
 			}
 		}
-	}
+	});
 }
 
 float calculate_x_overlap(Entity entity1, Entity entity2) {
@@ -431,7 +1164,7 @@ void PhysicsSystem::handle_mesh_collision(Entity mesh, Entity entity)
 	}
 
 	// Example - fireball
-	if (registry.damagings.has(entity) && registry.damagings.get(entity).type == "fireball") {
+	if (registry.damagings.has(entity) && registry.damagings.get(entity).type == DAMAGING_TYPE::FIREBALL) {
 		// Destroy the damaging
 		registry.remove_all_components_of(entity);
 		return;
@@ -519,24 +1252,36 @@ void PhysicsSystem::recoil_entities(Entity entity1, Entity entity2) {
 void PhysicsSystem::init(SoundSystem* sound)
 {
 	this->sound = sound;
+
+	// rebuild the static collision layer whenever obstacles or map tiles are added or removed
+	registry.obstacles.on_construct([this](Entity, Obstacle&) { staticLayerDirty = true; });
+	registry.obstacles.on_destroy([this](Entity, Obstacle&) { staticLayerDirty = true; });
+	registry.mapTiles.on_construct([this](Entity, MapTile&) { staticLayerDirty = true; });
+	registry.mapTiles.on_destroy([this](Entity, MapTile&) { staticLayerDirty = true; });
+
+	// a destroyed mesh entity's slot may be reused, drop its triangles
+	registry.meshPtrs.on_destroy([this](Entity entity, Mesh*&) { meshColliders.erase(entity.index()); });
 }
 
 void PhysicsSystem::step(float elapsed_ms)
 {
 	updatePositions(elapsed_ms);
+
+	auto start = std::chrono::steady_clock::now();
 	checkCollisions();
+	collisionCheckMs += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	collisionCheckFrames++;
 };
 
-std::vector<vec3> boundingBoxVertices(Motion& motion)
+std::array<vec3, 8> boundingBoxVertices(const Motion& motion)
 {
-	std::vector<vec3> vertices;
-	vertices.reserve(8);
+	std::array<vec3, 8> vertices;
+	int v = 0;
 	for (auto i : { -0.5f, 0.5f }) {
 		for (auto j : { -0.5f, 0.5f }) {
 			for (auto k : { -0.5f, 0.5f }) {
 				vec3 vertex = vec3(i, j, k);
-				vertex = tranformVertex(vertex, motion.position, motion.angle, motion.hitbox);
-				vertices.push_back(vertex);
+				vertices[v++] = tranformVertex(vertex, motion.position, motion.angle, motion.hitbox);
 			}
 		}
 	}
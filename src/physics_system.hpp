@@ -6,6 +6,30 @@
 #include "tiny_ecs_registry.hpp"
 #include "sound_system.hpp"
 
+#include <unordered_map>
+#include <array>
+
+// How checkCollisions finds the pairs that get the full test, switchable at runtime to compare them
+enum class BROADPHASE {
+	BRUTE_FORCE,
+	SPATIAL_HASH,
+	SWEEP_AND_PRUNE,
+	BROADPHASE_COUNT
+};
+const int broadphase_count = (int)BROADPHASE::BROADPHASE_COUNT;
+extern const char* const broadphase_names[broadphase_count];
+
+// Convex polygon of 3 or 4 vertices for the fixed-size SAT kernel, stored as columns so one edge or vertex sits in each lane
+// A triangle repeats its last vertex, which adds a zero-length edge that never separates anything
+struct SatPolygon
+{
+	vec4 x;
+	vec4 y;
+};
+SatPolygon satQuad(vec2 a, vec2 b, vec2 c, vec2 d);
+SatPolygon satTriangle(vec2 a, vec2 b, vec2 c);
+bool satCollide(const SatPolygon& polygon1, const SatPolygon& polygon2);
+
 // A simple physics system that moves rigid bodies and checks for collision
 class PhysicsSystem
 {
@@ -16,19 +40,116 @@ public:
 	// Array to store collision pairs
 	std::vector<std::pair<Entity, Entity>> collisions;
 
+	// Hits of projectiles found by sweeping them along their step, see sweepProjectiles()
+	// time is the fraction of the step at which body first touched other, body was moved back to that point
+	struct Impact { Entity body; Entity other; float time; };
+	std::vector<Impact> impacts;
+
+	// Switches the broadphase, printing the average collision check time of the previous one
+	void setBroadphase(BROADPHASE mode);
+	BROADPHASE getBroadphase() const { return broadphase; }
+
+	// Obstacles whose ground extent overlaps the square around centre, each listed once, looked up in the static layer
+	std::vector<Entity> obstaclesNear(vec2 centre, float radius);
+
 private:
 	SoundSystem* sound;
 
+	BROADPHASE broadphase = BROADPHASE::SPATIAL_HASH;
+	// Time spent in checkCollisions since the last switch
+	float collisionCheckMs = 0;
+	unsigned int collisionCheckFrames = 0;
+
+	// Scratch columns for the integration kernel, indexed like registry.motions.components
+	std::vector<float> groundZs;
+	std::vector<float> moveFactors;
+	std::vector<float> gravityFactors;
+
+	// Hitbox polygons in the xz plane, indexed like registry.motions.components, see checkCollisions()
+	std::vector<SatPolygon> boundingBoxPolygons;
+
+	// Broadphase scratch, see findCandidatePairs()
+	struct CellRange { vec2 low, high; int x0, y0, x1, y1; bool large; };
+	struct CellEntry { int x, y; unsigned int index; };
+	std::vector<CellRange> cellRanges; // indexed like registry.motions.components
+	std::vector<unsigned int> bucketStarts;
+	std::vector<CellEntry> cellEntries;
+	std::vector<unsigned int> largeEntities;
+	std::vector<std::pair<unsigned int, unsigned int>> candidatePairs;
+
+	// Static collision layer: obstacles (shrubs, rocks, trees, cliffs) never move, so their extents are bucketed once into
+	// a grid that the moving bodies query, see rebuildStaticLayer(). Rebuilt when obstacles or map tiles come or go.
+	enum BODY_LAYER : unsigned char { DYNAMIC_BODY, STATIC_BODY, IGNORED_BODY };
+	struct StaticBody { Entity entity; unsigned int motionIndex; vec2 low, high; int x0, y0, x1, y1; bool large; };
+	bool staticLayerDirty = true;
+	std::vector<StaticBody> staticBodies;
+	std::vector<unsigned int> largeStaticBodies; // too many cells, tested against every moving body
+	int staticGridX = 0, staticGridY = 0, staticGridWidth = 0, staticGridHeight = 0; // first cell and size in cells
+	std::vector<unsigned int> staticCellStarts; // staticGridWidth * staticGridHeight + 1 offsets into staticCellBodies
+	std::vector<unsigned int> staticCellBodies;
+	std::vector<unsigned char> layerOfSlot; // BODY_LAYER by entity slot, as of the last rebuild
+	std::vector<unsigned char> motionLayers; // BODY_LAYER indexed like registry.motions.components
+	std::vector<unsigned int> dynamicMotions; // motion indices of the moving bodies
+
+	// Projectiles and damagings swept from where they started the step to where they ended it, see sweepProjectiles()
+	struct SweptBody { Entity entity; unsigned int motionIndex; vec3 start; };
+	struct SweptHit { unsigned int body; float time; unsigned int other; }; // body indexes sweptBodies, other is a motion index
+	std::vector<SweptBody> sweptBodies;
+	std::vector<unsigned int> sweptBodyOfMotion; // indexed like registry.motions.components
+	std::vector<SweptHit> sweptHits;
+
+	// Triangles of a mesh entity in the frame meshCollides() tests in, with the entity's angle and scale applied,
+	// bucketed in a small AABB tree. Kept until the angle or scale of the entity changes, see meshCollider().
+	struct MeshTriangle { SatPolygon polygon; vec2 low, high; };
+	// Nodes in depth-first order, a node's first child follows it; skip is the node after its subtree
+	struct MeshTreeNode { vec2 low, high; unsigned int first, count, skip; }; // a leaf when count > 0
+	struct MeshCollider {
+		Entity entity;
+		const Mesh* mesh = nullptr;
+		float angle = 0;
+		vec2 scale = { 0, 0 };
+		std::vector<MeshTriangle> triangles;
+		std::vector<MeshTreeNode> nodes;
+	};
+	std::unordered_map<unsigned int, MeshCollider> meshColliders; // by entity slot
+
+	// Sweep and prune state, kept across frames, see sweepAndPrunePairs()
+	struct SweepBox { Entity entity; unsigned int motionIndex; vec2 low, high; bool live; };
+	struct SweepEndpoint { float value; unsigned int box; bool isMax; };
+	std::vector<SweepBox> sweepBoxes;
+	std::vector<unsigned int> freeSweepBoxes;
+	std::vector<SweepEndpoint> sweepEndpoints; // sorted along x
+	std::vector<unsigned int> sweepBoxOfSlot; // indexed by entity slot
+	// Boxes overlapping along x (see sweepPairKey()), in a flat list for the per-frame pass and with their list positions for removal
+	std::vector<unsigned long long> sweepPairs;
+	std::unordered_map<unsigned long long, unsigned int> sweepPairSlots;
+	std::vector<unsigned int> sweepActive;
+
 	void updatePositions(float elapsed_ms);
+	void rebuildStaticLayer();
+	void assignLayers();
+	void staticLayerPairs();
+	void bodyExtent(unsigned int i, vec2& low, vec2& high) const;
+	void spatialHashPairs();
+	void sweepAndPrunePairs();
+	void addSweepPair(unsigned long long key);
+	void removeSweepPair(unsigned long long key);
+	void sweepProjectiles();
+	bool pairOverlaps(unsigned int i, unsigned int j);
+	void testPair(unsigned int i, unsigned int j);
 	void checkCollisions();
 	void handleBoundsCheck();
 	void recoil_entities(Entity motion1, Entity motion2);
 	void handle_mesh_collision(Entity entityM, Entity other_entity);
 	void handle_obstacle_collision(Entity entityM, Entity obstacleM);
 	bool meshCollides(Entity& mesh_entity, Entity& other_entity);
+	const MeshCollider& meshCollider(Entity mesh_entity);
+	void buildMeshTree(MeshCollider& collider, unsigned int first, unsigned int count);
 };
 
-std::vector<vec3> boundingBoxVertices(Motion& motion);
+std::array<vec3, 8> boundingBoxVertices(const Motion& motion);
+
+// Generic SAT for polygons of any size, e.g. the AI's path polygons
 bool polygonsCollide(const std::vector<vec2>& polygon1, const std::vector<vec2>& polygon2);
 
 const float GRAVITATIONAL_CONSTANT = 0.01;
@@ -0,0 +1,128 @@
+#pragma once
+#include <vector>
+#include <functional>
+
+#include "tiny_ecs_registry.hpp"
+
+// Calls fn(handle) for every Entity member of a component, overloaded for the components that hold handles
+// Prefab uses it to point handles copied from the template at the entities of the new instance
+// IMPORTANT: a new component with Entity members needs an overload here
+template <typename T, typename Func>
+void for_each_handle(T&, Func) {}
+template <typename Func>
+void for_each_handle(Damaging& damaging, Func fn) { fn(damaging.excludedEntity); }
+template <typename Func>
+void for_each_handle(HomingProjectile& projectile, Func fn) { fn(projectile.targetEntity); }
+template <typename Func>
+void for_each_handle(HealthBar& bar, Func fn) { fn(bar.meshEntity); fn(bar.frameEntity); fn(bar.textEntity); }
+template <typename Func>
+void for_each_handle(StaminaBar& bar, Func fn) { fn(bar.meshEntity); fn(bar.frameEntity); fn(bar.textEntity); }
+template <typename Func>
+void for_each_handle(Collision& collision, Func fn) { fn(collision.other); }
+template <typename Func>
+void for_each_handle(Text& text, Func fn) { fn(text.anchoredWorldEntity); }
+
+// A template entity: copies of the components of an entity and of the entities attached to it, stamped onto new entities in bulk
+// Capture a fully built entity once, then instantiate() copies its component set instead of re-running the create function
+class Prefab
+{
+	// The template entity and each entity attached to it, parents before children
+	struct Part
+	{
+		Entity source; // the captured entity, used to remap handles to it, see remap()
+		int parent = -1; // index of the part this one is attached to, -1 for the root
+		Attachment attachment;
+		// One per component of source, copies the component onto the n entities of this part, see instantiate()
+		std::vector<std::function<void(const Prefab&, const Entity*, size_t, size_t)>> stamps;
+	};
+	std::vector<Part> parts;
+
+	void capture_part(Entity e, int parent)
+	{
+		Part part;
+		part.source = e;
+		part.parent = parent;
+		if (parent >= 0)
+			part.attachment = registry.attachments.get(e);
+		ComponentSignature owned = registry.signature(e);
+		registry.for_each_container([&](auto& container) {
+			// attachments are re-created with the new parent when instantiating
+			if (!(owned & ((ComponentSignature)1 << container.signature_bit)) || (void*)&container == (void*)&registry.attachments)
+				return;
+			auto* target = &container;
+			auto component = container.get(e);
+			auto cold = container.cold(e);
+			bool has_handles = false;
+			for_each_handle(component, [&](Entity&) { has_handles = true; });
+			part.stamps.push_back([target, component, cold, has_handles](const Prefab& prefab, const Entity* spawned, size_t n, size_t p) {
+				const Entity* es = spawned + p * n;
+				if (!has_handles) {
+					target->insert_n(es, n, component, cold);
+					return;
+				}
+				// handles to parts of the template must point at the same parts of each instance
+				target->reserve(target->size() + n);
+				for (size_t i = 0; i < n; i++) {
+					auto copy = component;
+					for_each_handle(copy, [&](Entity& handle) { handle = prefab.remap(handle, spawned, n, i); });
+					target->insert(es[i], copy);
+					target->cold(es[i]) = cold;
+				}
+			});
+		});
+		int index = (int)parts.size();
+		parts.push_back(std::move(part));
+
+		std::vector<Entity> children;
+		registry.children_of(e, children);
+		for (Entity child : children)
+			capture_part(child, index);
+	}
+
+public:
+	Prefab() = default;
+
+	// Captures the components of e and of everything attached to it, e is left as it is
+	explicit Prefab(Entity e)
+	{
+		capture_part(e, -1);
+	}
+
+	// True until something was captured
+	bool empty() const { return parts.empty(); }
+
+	// Number of entities created per instance, the root and its attachments
+	size_t part_count() const { return parts.size(); }
+
+	// Creates n instances, appending their entities to out grouped by part: out[first + part * n + i] is part of instance i
+	// The roots come first, so out[first + i] is instance i. Every component is inserted with one batch per container.
+	// Handles between the parts, such as HealthBar::meshEntity, are remapped to the instance's own entities (see for_each_handle)
+	void instantiate(size_t n, std::vector<Entity>& out) const
+	{
+		size_t first = out.size();
+		out.reserve(first + parts.size() * n);
+		for (size_t i = 0; i < parts.size() * n; i++)
+			out.push_back(Entity::create());
+		const Entity* spawned = &out[first];
+		for (size_t p = 0; p < parts.size(); p++) {
+			const Entity* entities = spawned + p * n;
+			for (auto& stamp : parts[p].stamps)
+				stamp(*this, spawned, n, p);
+			if (parts[p].parent < 0)
+				continue;
+			const Entity* parents = &out[first + parts[p].parent * n];
+			for (size_t i = 0; i < n; i++)
+				registry.attach(entities[i], parents[i], parts[p].attachment.offset, parts[p].attachment.aboveParent);
+		}
+	}
+
+	// The entity of instance i that stands in for source, handles to anything outside the template are returned as they are
+	// spawned points at the first entity instantiate() appended for the n instances
+	Entity remap(Entity source, const Entity* spawned, size_t n, size_t i) const
+	{
+		for (size_t p = 0; p < parts.size(); p++)
+			if (parts[p].source == source)
+				return spawned[p * n + i];
+		return source;
+	}
+};
@@ -11,6 +11,7 @@
 
 // STD
 #include <algorithm>
+#include <cfloat>
 #include <sstream>
 #include <glm/gtx/string_cast.hpp>
 
@@ -29,12 +30,14 @@ void RenderSystem::drawText(Entity entity, const mat4& projection_screen) {
 
 	glActiveTexture(GL_TEXTURE0);
 
-	std::vector<vec2> renderPositions = getTextRenderPositions(text.value, fg.scale.x, text.lineSpacing, text.alignment, fg.position);
-
-	float lineIndex = 0;
-	float startX = renderPositions[lineIndex].x;
-	float startY = renderPositions[lineIndex].y;
 	const float scale = fg.scale.x;
+	if (text.lineOffsets.empty()) {
+		return;
+	}
+
+	size_t lineIndex = 0;
+	float startX = fg.position.x + text.lineOffsets[lineIndex].x * scale;
+	float startY = fg.position.y + text.lineOffsets[lineIndex].y * scale;
 
 	std::string::const_iterator c;
     for (c = text.value.begin(); c != text.value.end(); c++)
@@ -43,8 +46,8 @@ void RenderSystem::drawText(Entity entity, const mat4& projection_screen) {
 
 		if (*c == '\n') {
 			lineIndex++;
-			startX = renderPositions[lineIndex].x;
-        	startY = renderPositions[lineIndex].y;
+			startX = fg.position.x + text.lineOffsets[lineIndex].x * scale;
+        	startY = fg.position.y + text.lineOffsets[lineIndex].y * scale;
         	continue;
     	}
 
@@ -303,7 +306,7 @@ void RenderSystem::bindAnimationAttributes(const GLuint program, const Entity &e
     GLint currentFrame_loc = glGetUniformLocation(program, "current_frame");
 
     AnimationController animationController = registry.animationControllers.get(entity);
-    Animation currentAnimation = animationController.animations[animationController.currentState];
+    Animation currentAnimation = animationController.animations[(int)animationController.currentState];
     glUniform1f(numFrames_loc, currentAnimation.numFrames);       // Set numFrames value
     glUniform1f(currentFrame_loc, currentAnimation.currentFrame); // Set currentFrame value
     gl_has_errors();
@@ -390,21 +393,14 @@ void RenderSystem::bindPointLights(const GLuint program, const Entity& entity, c
 	}
 }
 
-// Returns true if entity a is further from the camera
-bool renderComparison(Entity a, Entity b)
+// Depth key of a midground entity, smaller keys are further from the camera and drawn first
+// Entities without a motion are drawn last, ties are broken by entity id
+static std::pair<float, unsigned int> renderDepth(Entity e)
 {
-	if (!registry.motions.has(a)) {
-		return false;
-	}
-	if (!registry.motions.has(b)) {
-		return true;
+	if (!registry.motions.has(e)) {
+		return { FLT_MAX, e.getId() };
 	}
-	Motion& motionA = registry.motions.get(a);
-	Motion& motionB = registry.motions.get(b);
-	if (motionA.position.y == motionB.position.y) {
-		return a < b;
-	}
-	return motionA.position.y < motionB.position.y;
+	return { registry.motions.get(e).position.y, e.getId() };
 }
 
 // Render our game world
@@ -438,17 +434,21 @@ void RenderSystem::draw()
 		drawMesh(entity, projection_2D, projection_screen);
 	}
 	
-	// Copy entities and sort
-	std::vector<Entity> renderOrder = registry.midgrounds.entities;
-	std::sort(renderOrder.begin(), renderOrder.end(), renderComparison);
+	// Sort back to front, the container keeps last frame's order so it is nearly sorted already
+	registry.midgrounds.sort_by_key(renderDepth, true);
 	// Draw all midground textured meshes that have a position and size component
-	for (Entity entity : renderOrder) {
+	for (Entity entity : registry.midgrounds.entities) {
 		drawMesh(entity, projection_2D, projection_screen);
 	}
 
 	// Draw all particles
 	particles->draw((GLuint)effects[(GLuint)EFFECT_ASSET_ID::PARTICLE]);
 
+	// Lay out only the texts that were added or changed this frame
+	registry.view<Changed<Text>>().each([](Entity entity, Text& text) {
+		text.lineOffsets = getTextLineOffsets(text.value, text.lineSpacing, text.alignment);
+	});
+
 	// Draw all foreground textures
 	for (Entity entity : registry.foregrounds.entities) {
 		if(entity == registry.fpsTracker.textEntity && !registry.fpsTracker.toggled) {
@@ -468,8 +468,8 @@ void RenderSystem::draw()
 
 void RenderSystem::step(float elapsed_ms)
 {
-	for (Entity entity : registry.damageds.entities) {
-		Damaged& timer = registry.damageds.get(entity);
+	// the view iterates backwards, so removing the current entity does not skip any
+	registry.view<Damaged>().each([&](Entity entity, Damaged& timer) {
 		timer.timer -= elapsed_ms;
 		if (timer.timer < 0) {
 			registry.damageds.remove(entity);
@@ -477,7 +477,7 @@ void RenderSystem::step(float elapsed_ms)
 				registry.colours.remove(entity);
 			}
 		}
-	}
+	});
 
 	for (Entity entity : registry.invulnerables.entities) {
 		Invulnerable& invulnerable = registry.invulnerables.get(entity);
@@ -492,16 +492,14 @@ void RenderSystem::step(float elapsed_ms)
 	}
 
 	// Update animation frames
-	for (auto& animationController : registry.animationControllers.components) {
-		updateAnimation(animationController.animations[animationController.currentState], elapsed_ms);
-	}
+	registry.par_for_each<AnimationController>([elapsed_ms](Entity, AnimationController& animationController) {
+		updateAnimation(animationController.animations[(int)animationController.currentState], elapsed_ms);
+	}, 64);
 
 	updateExplosions(elapsed_ms);
 
-	for (Entity entity : registry.projectiles.entities) {
-		Motion& motion = registry.motions.get(entity);
+	registry.view<Projectile, Motion>().each([&](Entity entity, Projectile& projectile, Motion& motion) {
 		if (length(motion.velocity) == 0) {
-			Projectile& projectile = registry.projectiles.get(entity);
 			projectile.sticksInGround -= elapsed_ms;
 			if (projectile.sticksInGround <= 0) {
 	
@@ -515,16 +513,16 @@ void RenderSystem::step(float elapsed_ms)
 				}
 				registry.remove_all_components_of(entity);
 			}
-			continue;
+			return;
 		}
 		vec2 direction = normalize(worldToVisual(motion.velocity));
 		motion.angle = atan2(direction.y, direction.x);
-	}
+	});
 	update_animations();
 	update_hpbars();
 	update_staminabars();
 	updateEntityFacing();
-	updateCollectedPosition();
+	updateAttachments();
 	updateSlideUps(elapsed_ms);
 }
 
@@ -581,8 +579,8 @@ void RenderSystem::update_bow_animations() {
 		Entity entity = registry.inventory.equippedEntity;
 		AnimationController& ac = registry.animationControllers.get(entity);
 		if(ac.currentState == AnimationState::Attack && 
-			ac.animations[ac.currentState].currentFrame == 0 &&
-			ac.animations[ac.currentState].elapsedTime == 0) {
+			ac.animations[(int)ac.currentState].currentFrame == 0 &&
+			ac.animations[(int)ac.currentState].elapsedTime == 0) {
 			ac.changeState(entity, AnimationState::Default);
 		}	
 	}
@@ -608,65 +606,26 @@ void RenderSystem::turn_damaged_red(std::vector<Entity>& was_damaged)
 	}
 }
 
-void handleHpBarBoundsCheck() {
-	for(Entity& entity : registry.enemies.entities) {
-		HealthBar& hpbar = registry.healthBars.get(entity);
-		Motion& motion = registry.motions.get(hpbar.meshEntity);
-		float halfScaleX = motion.scale.x / 2;
-		float halfScaleY = visualToWorldY(motion.scale.y) / 2;
-
-		if(motion.position.x - halfScaleX  < 0) {
-			motion.position.x = halfScaleX;
-		} else if(motion.position.x + halfScaleX > world_size_x) {
-			motion.position.x = world_size_x - halfScaleX;
+// Moves every attached entity (health and stamina bars, collected and equipped items) to its parent's position plus its offset
+// A single pass is enough, because the attachments are sorted so that parents come before their children
+void RenderSystem::updateAttachments() {
+	registry.sort_attachments();
+	ComponentContainer<Attachment>& attachments = registry.attachments;
+	for (size_t i = 0; i < attachments.size(); i++) {
+		const Attachment& attachment = attachments.components[i];
+		Entity entity = attachments.entities[i];
+		if (!registry.motions.has(entity) || !registry.motions.has(attachment.parent)) {
+			continue;
 		}
-
-		if(motion.position.y - halfScaleY - motion.position.z < 0) {
-			motion.position.y = visualToWorldY(motion.scale.y);
-			motion.position.z = -5;
-		} else if(motion.position.y + halfScaleY > world_size_y) {
-			motion.position.y = world_size_y - halfScaleY;
+		Motion& parentMotion = registry.motions.get(attachment.parent);
+		Motion& motion = registry.motions.get(entity);
+		motion.position = parentMotion.position + attachment.offset;
+		if (attachment.aboveParent) {
+			motion.position.z += visualToWorldY(parentMotion.scale.y) / 2;
 		}
-
-		Motion& hpFrameMotion = registry.motions.get(hpbar.frameEntity);
-		hpFrameMotion.position = motion.position;
 	}
 }
 
-void updateHpBarPositionHelper(const std::vector<Entity>& entities) {
-    for (Entity entity : entities) {
-	    HealthBar& healthBar = registry.healthBars.get(entity);
-        Motion& motion = registry.motions.get(entity);
-        Motion& healthBarMotion =  registry.motions.get(healthBar.meshEntity);
-		float topOffset = 25;
-         // place above character
-		 if(registry.players.has(entity)) {
-			topOffset += healthBar.height + 5;
-		 }
-		healthBarMotion.position.x = motion.position.x - (healthBar.width / 2);
-        healthBarMotion.position.y = motion.position.y;
-		healthBarMotion.position.z = motion.position.z + visualToWorldY(motion.scale.y) / 2 + topOffset;
-		Motion& hpFrameMotion =  registry.motions.get(healthBar.frameEntity);
-		hpFrameMotion.position = healthBarMotion.position;
-    }   
-}
-
-void RenderSystem::updateCollectedPosition() {
-	Entity& playerE = registry.players.entities[0];
-	Motion& playerM = registry.motions.get(playerE);
-	HealthBar& hpBar = registry.healthBars.get(playerE);
-
-    for (Entity entity : registry.collected.entities) {
-        Motion& collectedM =  registry.motions.get(entity);
-        // place above character
-        float topOffset = 30;
-		float horizontalOffset = hpBar.width / 2;
-		collectedM.position.x = playerM.position.x + horizontalOffset + 15;
-        collectedM.position.y = playerM.position.y;
-		collectedM.position.z = playerM.position.z + visualToWorldY(playerM.scale.y) / 2 + topOffset;
-    }   
-}
-
 void RenderSystem::updateSlideUps(float elapsed_ms) {
 	for (Entity entity : registry.slideUps.entities) {
 		SlideUp& slideUp = registry.slideUps.get(entity);
@@ -683,7 +642,7 @@ void RenderSystem::updateSlideUps(float elapsed_ms) {
 			Foreground& textFg = registry.foregrounds.get(entity);
 
 			// follow the anchored entity
-			if(registry.motions.has(text.anchoredWorldEntity)) { 
+			if(registry.valid(text.anchoredWorldEntity) && registry.motions.has(text.anchoredWorldEntity)) { 
 				Motion& anchoredMotion = registry.motions.get(text.anchoredWorldEntity);
 				vec2 screenPos = worldToScreen({anchoredMotion.position.x + text.anchoredWorldOffset.x, anchoredMotion.position.y + text.anchoredWorldOffset.y, 0.0f});
 
@@ -708,7 +667,7 @@ void RenderSystem::updateSlideUps(float elapsed_ms) {
 		}
 
 		if(slideUp.animationLength <= 0) {
-			registry.remove_all_components_of(entity);
+			registry.destroy_deferred(entity);
 		}
 	}
 }
@@ -718,54 +677,42 @@ void updateHpBarMeter() {
 	Player& player = registry.players.get(entity);
 	
 	PlayerResourceUI& playerUI = registry.playerResourceUI;
-	Foreground& fg = registry.foregrounds.get(playerUI.hpMeshEntity);
-	fg.scale.x = playerUI.hpMaxSize.x * player.health/100.f;
-	Text& text = registry.texts.get(playerUI.hpTextEntity);
-	std::stringstream ss;
-	ss << "HP" << std::string(8, ' ') << std::to_string(player.health) << "/100";
-	text.value = ss.str();
-
-	HealthBar& playerHPBar = registry.healthBars.get(entity);
-	Motion& playerHPMotion = registry.motions.get(playerHPBar.meshEntity);
-	playerHPMotion.scale.x = playerHPBar.width * player.health/100.f;
-
-	if(player.health <= 30.0f) {
-		vec4 red = {1.0f, 0.0f, 0.0f, 1.0f};
-		registry.colours.get(playerUI.hpMeshEntity) = red;
-		registry.colours.get(playerUI.hpFrameEntity) = red;
-		registry.colours.get(playerHPBar.meshEntity) = red;
-		registry.colours.get(playerHPBar.frameEntity) = red;
-	}
-	else if(player.health <= 60.0f) {
-		vec4 orange = {1.0f, 0.45f, 0.0f, 1.0f};
-		registry.colours.get(playerUI.hpMeshEntity) = orange;
-		registry.colours.get(playerUI.hpFrameEntity) = orange;
-		registry.colours.get(playerHPBar.meshEntity) = orange;
-		registry.colours.get(playerHPBar.frameEntity) = orange;
-	} else {
-		vec4 green = {0.0f, 1.0f, 0.0f, 1.0f};
-		registry.colours.get(playerUI.hpMeshEntity) = green;
-		registry.colours.get(playerUI.hpFrameEntity) = green;
-		registry.colours.get(playerHPBar.meshEntity) = green;
-		registry.colours.get(playerHPBar.frameEntity) = green;
+	// the player's meters, text and colours only need an update when the health changed
+	if ((int)player.health != playerUI.shownHealth) {
+		playerUI.shownHealth = (int)player.health;
+		Foreground& fg = registry.foregrounds.get(playerUI.hpMeshEntity);
+		fg.scale.x = playerUI.hpMaxSize.x * player.health/100.f;
+		std::stringstream ss;
+		ss << "HP" << std::string(8, ' ') << std::to_string(player.health) << "/100";
+		setTextValue(playerUI.hpTextEntity, ss.str());
+
+		HealthBar& playerHPBar = registry.healthBars.get(entity);
+		Motion& playerHPMotion = registry.motions.get(playerHPBar.meshEntity);
+		playerHPMotion.scale.x = playerHPBar.width * player.health/100.f;
+
+		vec4 colour = {0.0f, 1.0f, 0.0f, 1.0f}; // green
+		if(player.health <= 30.0f) {
+			colour = {1.0f, 0.0f, 0.0f, 1.0f}; // red
+		}
+		else if(player.health <= 60.0f) {
+			colour = {1.0f, 0.45f, 0.0f, 1.0f}; // orange
+		}
+		registry.colours.get(playerUI.hpMeshEntity) = colour;
+		registry.colours.get(playerUI.hpFrameEntity) = colour;
+		registry.colours.get(playerHPBar.meshEntity) = colour;
+		registry.colours.get(playerHPBar.frameEntity) = colour;
 	}
 	
 	for (Entity entity : registry.enemies.entities) {
 		Enemy& enemy = registry.enemies.get(entity);
 		HealthBar& hpbar = registry.healthBars.get(entity);
 		Motion& motion = registry.motions.get(hpbar.meshEntity);
-		motion.scale.x = hpbar.width * enemy.health/enemy.maxHealth;
+		motion.scale.x = hpbar.width * enemy.health/registry.enemies.cold(entity).maxHealth;
 	}
 }
 
-void updateHpBarPosition() {
-	updateHpBarPositionHelper(registry.players.entities);
-    updateHpBarPositionHelper(registry.enemies.entities);
-}
-
 void RenderSystem::update_hpbars() {
 	updateHpBarMeter();
-	updateHpBarPosition();
 }
 
 void RenderSystem::update_staminabars() {
@@ -776,34 +723,24 @@ void RenderSystem::update_staminabars() {
 	Foreground& fg = registry.foregrounds.get(playerUI.staminaMeshEntity);
 	Stamina& stamina = registry.staminas.get(entity);
 	StaminaBar& staminaBar = registry.staminaBars.get(entity);
-	Motion& playerMotion = registry.motions.get(entity);
 	Motion& staminaBarMotion =  registry.motions.get(staminaBar.meshEntity);
-	Motion& staminaBarFrameMotion =  registry.motions.get(staminaBar.frameEntity);
 
 	// update meter
 	fg.scale.x = playerUI.staminaMaxSize.x * stamina.stamina/stamina.max_stamina;
 	staminaBarMotion.scale.x = staminaBar.width * stamina.stamina/stamina.max_stamina;
-	Text& text = registry.texts.get(playerUI.staminaTextEntity);
-	std::stringstream ss;
-	ss << "Stamina" << std::string(8, ' ') << std::to_string((int)stamina.stamina) << "/100";
-	text.value = ss.str();
-
-	// update position
-    // place above character
-	float topOffset = 25;
-	staminaBarMotion.position.x = playerMotion.position.x - (staminaBar.width / 2);
-    staminaBarMotion.position.y = playerMotion.position.y;
-	staminaBarMotion.position.z = playerMotion.position.z + visualToWorldY(playerMotion.scale.y) / 2 + topOffset;
-	staminaBarFrameMotion.position = staminaBarMotion.position;
+	if ((int)stamina.stamina != playerUI.shownStamina) {
+		playerUI.shownStamina = (int)stamina.stamina;
+		std::stringstream ss;
+		ss << "Stamina" << std::string(8, ' ') << std::to_string(playerUI.shownStamina) << "/100";
+		setTextValue(playerUI.staminaTextEntity, ss.str());
+	}
 }
 
 void RenderSystem::updateEntityFacing() {
+	// only write the scale when the sign has to flip, so untouched motions stay clean
 	for (Motion& motion : registry.motions.components) {
-    if (motion.facing.x > 0) {
-      motion.scale.x = abs(motion.scale.x);
-    }
-    else if (motion.facing.x < 0) {
-      motion.scale.x = -1.0f * abs(motion.scale.x);
+    if ((motion.facing.x > 0 && motion.scale.x < 0) || (motion.facing.x < 0 && motion.scale.x > 0)) {
+      motion.scale.x = -motion.scale.x;
     }
 	}
 }
@@ -910,35 +847,34 @@ vec2 RenderSystem::worldToScreen(vec3 worldPos) {
 	return { screenPosX, screenPosY };
 }
 
-std::vector<vec2> getTextRenderPositions(std::string textValue, float scale, float lineSpacing, TEXT_ALIGNMENT alignment, vec2 alignmentPos) {
-    std::vector<vec2> renderPositions;
+std::vector<vec2> getTextLineOffsets(const std::string& textValue, float lineSpacing, TEXT_ALIGNMENT alignment) {
+    std::vector<vec2> lineOffsets;
     float textLength = 0;
-    float lineIndex = 0;
-	float renderPosY = alignmentPos.y;
-    float lineHeight = registry.textChars['H'].size.y * scale * lineSpacing; 
+	float offsetY = 0;
+    float lineHeight = registry.textChars['H'].size.y * lineSpacing;
 
     for (auto c = textValue.begin(); c != textValue.end(); c++) {
         if (*c != '\n') {
             TextChar ch = registry.textChars[*c];
-            textLength += (ch.advance >> 6) * scale;
+            textLength += (ch.advance >> 6);
         }
 
         // If newline or last character
         if (*c == '\n' || c == textValue.end() - 1) {
             if (alignment == TEXT_ALIGNMENT::CENTER) {
-                renderPositions.push_back({alignmentPos.x - textLength / 2, renderPosY});
+                lineOffsets.push_back({-textLength / 2, offsetY});
             } else if (alignment == TEXT_ALIGNMENT::RIGHT) {
-                renderPositions.push_back({alignmentPos.x - textLength, renderPosY});
+                lineOffsets.push_back({-textLength, offsetY});
             } else {
-                renderPositions.push_back({alignmentPos.x, renderPosY});
+                lineOffsets.push_back({0.f, offsetY});
             }
 
-			renderPosY -= lineHeight;
+			offsetY -= lineHeight;
             textLength = 0;
         }
     }
 
-    return renderPositions;
+    return lineOffsets;
 }
 
 float worldToVisualY(float y, float z) 
@@ -218,7 +218,7 @@ private:
 
 	void updateEntityFacing();
 
-    void updateCollectedPosition();
+	void updateAttachments();
 
 	void updateSlideUps(float elapsed_ms);
 	void updateExplosions(float elapsed_ms);
@@ -227,7 +227,8 @@ private:
 	GLFWwindow* window;
 };
 
-std::vector<vec2> getTextRenderPositions(std::string textValue, float scale, float lineSpacing, TEXT_ALIGNMENT alignment, vec2 alignmentPos);
+// Start of every line of a text relative to its alignment position, at scale 1
+std::vector<vec2> getTextLineOffsets(const std::string& textValue, float lineSpacing, TEXT_ALIGNMENT alignment);
 
 bool loadEffectFromFile(
 	const std::string& vs_path, const std::string& fs_path, GLuint& out_program);
@@ -21,11 +21,11 @@ void SpawnManager::setTutorialMode(bool mode) {
 	isTutorialModeOn = mode;
 }
 
-vec2 SpawnManager::get_spawn_location(const std::string& entity_type, bool initial)
+vec2 SpawnManager::get_spawn_location(SPAWNABLE_TYPE entity_type, bool initial)
 {
     vec2 spawn_location{};
     // spawn collectibles
-    if (entity_type == "heart" || entity_type == "collectible_trap") {
+    if (entity_type == SPAWNABLE_TYPE::HEART || entity_type == SPAWNABLE_TYPE::COLLECTIBLE_TRAP) {
         // spawn at random location on the map
         float posX = uniform_dist(rng) * (rightBound - leftBound) + leftBound;
         float posY = uniform_dist(rng) * (bottomBound - topBound) + topBound;
@@ -74,20 +74,20 @@ vec2 SpawnManager::get_spawn_location(const std::string& entity_type, bool initi
 }
 
 bool SpawnManager::hasAllEnemiesSpawned() {
-	return currentEnemyIdx >= entity_types.size() - 2; // there are 2 collectibles
+	return currentEnemyIdx >= spawnable_type_count - 2; // there are 2 collectibles
 }
 
 void SpawnManager::initialSpawn(float elapsed_ms) {
     int maxEntitySize = 1;
 
     for (int i = 0; i < currentEnemyIdx; i++) {
-        std::string entity_type = entity_types[i];
-        int currentEntitySize = registry.spawnable_lists.at(entity_type)->size();
+        SPAWNABLE_TYPE entity_type = (SPAWNABLE_TYPE)i;
+        int currentEntitySize = registry.spawn_counts[i];
         if (currentEntitySize < maxEntitySize) {
             vec2 spawn_location = get_spawn_location(entity_type, isTutorialModeOn);
-            spawn_func f = spawn_functions.at(entity_type);
+            spawn_func f = spawn_functions[i];
             (*f)(spawn_location);
-            std::cout << "Spawning " + entity_type << std::endl;
+            std::cout << "Spawning " << spawnable_type_names[i] << std::endl;
         }
     }
 
@@ -96,9 +96,9 @@ void SpawnManager::initialSpawn(float elapsed_ms) {
     // spawn new enemy
     if (initialSpawnTime <= 0) {
         // spawn current enemy
-		std::string entity_type = entity_types[currentEnemyIdx];
+		SPAWNABLE_TYPE entity_type = (SPAWNABLE_TYPE)currentEnemyIdx;
 		vec2 spawn_location = get_spawn_location(entity_type, true);
-		spawn_func f = spawn_functions.at(entity_type);
+		spawn_func f = spawn_functions[currentEnemyIdx];
 		(*f)(spawn_location);
 		currentEnemyIdx++;
 		initialSpawnTime = initialSpawnInterval;
@@ -115,41 +115,54 @@ void SpawnManager::inGameSpawn(float elapsed_ms) {
 }
 
 void SpawnManager::spawnEnemies(float elapsed_ms) {
-    for (int i = 0; i < entity_types.size(); i++) {
-        std::string entity_type = entity_types[i];
+    for (int i = 0; i < spawnable_type_count; i++) {
+        SPAWNABLE_TYPE entity_type = (SPAWNABLE_TYPE)i;
 
-		next_spawn.at(entity_type) -= elapsed_ms;
+		next_spawn[i] -= elapsed_ms;
 
-		bool isWithinMaxSize = registry.spawnable_lists.at(entity_type)->size() < max_entities.at(entity_type);
-		bool hasReachedSpawnTime = next_spawn.at(entity_type) <= 0;
+		bool isWithinMaxSize = registry.spawn_counts[i] < max_entities[i];
+		bool hasReachedSpawnTime = next_spawn[i] <= 0;
         if (isWithinMaxSize && hasReachedSpawnTime) {
             
-			int num_to_spawn = spawn_size.at(entity_type);
-            spawn_func f = spawn_functions.at(entity_type);
+			int num_to_spawn = spawn_size[i];
+            spawn_positions.clear();
             for (int j = 0; j < num_to_spawn; j++) {
-                vec2 spawn_location = get_spawn_location(entity_type, false);
-                (*f)(spawn_location);
+                spawn_positions.push_back(get_spawn_location(entity_type, false));
             }
 
-			next_spawn.at(entity_type) = spawn_delays.at(entity_type);
+            if (entity_type == SPAWNABLE_TYPE::COLLECTIBLE_TRAP) {
+                // the trap rolls its type per instance, so it has no single prefab
+                for (vec2 spawn_location : spawn_positions) {
+                    createCollectibleTrap(spawn_location);
+                }
+            }
+            else {
+                if (prefabs[i].empty()) {
+                    prefabs[i] = createPrefab(spawn_functions[i]);
+                }
+                spawn_n(prefabs[i], spawn_positions);
+            }
+
+			next_spawn[i] = spawn_delays[i];
         }
     }
 }
 
 void SpawnManager::spawnCollectibles(float elapsed_ms) {
 	// collectible
-	spawnCollectible("collectible_trap", elapsed_ms); // collectible_trap
+	spawnCollectible(SPAWNABLE_TYPE::COLLECTIBLE_TRAP, elapsed_ms); // collectible_trap
     // heart
-	spawnCollectible("heart", elapsed_ms); // heart
+	spawnCollectible(SPAWNABLE_TYPE::HEART, elapsed_ms); // heart
 }
 
-void SpawnManager::spawnCollectible(std::string collectible, float elapsed_ms) {
-    next_spawn.at(collectible) -= elapsed_ms;
-    if (next_spawn.at(collectible) <= 0) {
+void SpawnManager::spawnCollectible(SPAWNABLE_TYPE collectible, float elapsed_ms) {
+    int i = (int)collectible;
+    next_spawn[i] -= elapsed_ms;
+    if (next_spawn[i] <= 0) {
         vec2 trap_spawn_location = get_spawn_location(collectible, false);
-        spawn_func f = spawn_functions.at(collectible);
+        spawn_func f = spawn_functions[i];
         (*f)(trap_spawn_location);
-        next_spawn.at(collectible) = spawn_delays.at(collectible);
+        next_spawn[i] = spawn_delays[i];
     }
 }
 
@@ -170,7 +183,7 @@ void SpawnManager::spawnParticles(float elapsed_ms)
 
     for (Entity fireball : registry.damagings.entities) {
         Damaging& damaging = registry.damagings.get(fireball);
-        if (damaging.type != "fireball") {
+        if (damaging.type != DAMAGING_TYPE::FIREBALL) {
             continue;
         }
         vec3 position = registry.motions.get(fireball).position;
@@ -227,12 +240,12 @@ void SpawnManager::adjustDifficulty(float elapsed_ms) {
     if (difficultyTime >= difficultyInterval) {
         // increase max size by 2
         const int incrementCount = 2;
-        for (auto& entity_max : max_entities) {
-            entity_max.second += incrementCount;
+        for (int& entity_max : max_entities) {
+            entity_max += incrementCount;
         }
         // decrease spawn time
-        for (auto& spawn_time : spawn_delays) {
-            spawn_time.second *= 0.9;
+        for (float& spawn_time : spawn_delays) {
+            spawn_time *= 0.9;
         }
         // reset
         difficultyTime = 0;
@@ -245,12 +258,8 @@ void SpawnManager::adjustDifficulty(float elapsed_ms) {
 void SpawnManager::resetSpawnSystem() {
     currentEnemyIdx = 0;
     initialSpawnTime = 0.f;
-    for (auto& entity_spawn : next_spawn) {
-        entity_spawn.second = spawn_delays_og.at(entity_spawn.first);
-    }
-    for (auto& entity_max : max_entities) {
-        entity_max.second = max_entities_og.at(entity_max.first);
-    }
+    next_spawn = spawn_delays_og;
+    max_entities = max_entities_og;
 }
 
 void SpawnManager::step(float elapsed_ms) {
@@ -2,7 +2,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <array>
 
 #include <world_init.hpp>
 #include <sound_system.hpp>
@@ -33,105 +33,48 @@ private:
 	float difficultyTime = 10000.f;
 
 	// Constants
-	std::vector<std::string> entity_types = {
-		"bird",
-		"boar",
-		"barbarian",
-		"archer",
-		"wizard",
-		"troll",
-		"bomber",
-		"heart", // collectible
-		"collectible_trap" // collectible
-	};
+	// Every table is indexed by (int)SPAWNABLE_TYPE, so entries are in the order
+	// bird, boar, barbarian, archer, wizard, troll, bomber, heart, collectible_trap
+	template <typename T>
+	using spawn_table = std::array<T, spawnable_type_count>;
 
-	const std::unordered_map<std::string, float> spawn_delays_og = {
-		{"boar", 30000.0},
-		{"barbarian", 40000.0f},
-		{"archer", 50000.0f},
-		{"bird", 20000.0f},
-		{"wizard", 60000.0f},
-		{"troll", 70000.0f},
-		{"bomber", 90000.0f},
-		{"heart", 10000.0f},
-		{"collectible_trap", 10000.0f}
+	const spawn_table<float> spawn_delays_og = {
+		20000.0f, 30000.0f, 40000.0f, 50000.0f, 60000.0f, 70000.0f, 90000.0f, 10000.0f, 10000.0f
 	};
 
-	std::unordered_map<std::string, float> spawn_delays = {
-		{"boar", 30000.0},
-		{"barbarian", 40000.0f},
-		{"archer", 50000.0f},
-		{"bird", 20000.0f},
-		{"wizard", 60000.0f},
-		{"troll", 70000.0f},
-		{"bomber", 90000.0f},
-		{"heart", 10000.0f},
-		{"collectible_trap", 10000.0f}
-	};
+	spawn_table<float> spawn_delays = spawn_delays_og;
 
-	std::unordered_map<std::string, float> next_spawn = {
-		{"boar", 30000.0},
-		{"barbarian", 40000.0f},
-		{"archer", 50000.0f},
-		{"bird", 20000.0f},
-		{"wizard", 60000.0f},
-		{"troll", 70000.0f},
-		{"bomber", 90000.0f},
-		{"heart", 10000.0f},
-		{"collectible_trap", 10000.0f}
-	};
+	spawn_table<float> next_spawn = spawn_delays_og;
 
 	// By how many entities to increase at spawn delay
-	const std::unordered_map<std::string, int> spawn_size = {
-		{"boar", 2},
-		{"barbarian", 2},
-		{"archer", 1},
-		{"bird", 2},
-		{"wizard", 1},
-		{"troll", 1},
-		{"bomber", 1},
-		{"heart", 2},
-		{"collectible_trap", 2}
+	const spawn_table<int> spawn_size = {
+		2, 2, 2, 1, 1, 1, 1, 2, 2
 	};
 
-	const std::unordered_map<std::string, int> max_entities_og = {
-		{"boar", 5},
-		{"barbarian", 4},
-		{"archer", 3},
-		{"bird", 8},
-		{"wizard", 4},
-		{"troll", 5},
-		{"bomber", 3},
-		{"heart", 2},
-		{"collectible_trap", 2}
+	const spawn_table<int> max_entities_og = {
+		8, 5, 4, 3, 4, 5, 3, 2, 2
 	};
 
-	std::unordered_map<std::string, int> max_entities = {
-		{"boar", 5},
-		{"barbarian", 4},
-		{"archer", 3},
-		{"bird", 8},
-		{"wizard", 4},
-		{"troll", 5},
-		{"bomber", 3},
-		{"heart", 2},
-		{"collectible_trap", 2}
-	};
+	spawn_table<int> max_entities = max_entities_og;
 
 	using spawn_func = Entity(*)(vec2);
-	const std::unordered_map<std::string, spawn_func> spawn_functions = {
-		{"boar", createBoar},
-		{"barbarian", createBarbarian},
-		{"archer", createArcher},
-		{"bird", createBird},
-		{"wizard", createWizard},
-		{"troll", createTroll},
-		{"bomber", createBomber},
-		{"heart", createHeart},
-		{"collectible_trap", createCollectibleTrap}
+	const spawn_table<spawn_func> spawn_functions = {
+		createBird,
+		createBoar,
+		createBarbarian,
+		createArcher,
+		createWizard,
+		createTroll,
+		createBomber,
+		createHeart,
+		createCollectibleTrap
 	};
 
-	vec2 get_spawn_location(const std::string& entity_type, bool initial);
+	// Built from spawn_functions on first use, see spawnEnemies()
+	spawn_table<Prefab> prefabs;
+	std::vector<vec2> spawn_positions;
+
+	vec2 get_spawn_location(SPAWNABLE_TYPE entity_type, bool initial);
 	bool hasAllEnemiesSpawned();
 
 	void initialSpawn(float elapsed_ms);
@@ -139,7 +82,7 @@ private:
 
 	void spawnEnemies(float elapsed_ms);
 	void spawnCollectibles(float elapsed_ms);
-	void spawnCollectible(std::string collectible, float elapsed_ms);
+	void spawnCollectible(SPAWNABLE_TYPE collectible, float elapsed_ms);
 	void spawnParticles(float elapsed_ms);
 
 	void despawnCollectibles(float elapsed_ms);
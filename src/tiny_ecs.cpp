@@ -5,5 +5,90 @@
 // internal
 #include "tiny_ecs.hpp"
 
-// All we need to store besides the containers is the id of every entity and callbacks to be able to remove entities across containers
-unsigned int Entity::id_count = 1;
\ No newline at end of file
+// Function-local static so entities created during static initialization (e.g. the registry's members) are safe
+static EntitySlots& slots()
+{
+	static EntitySlots entity_slots;
+	return entity_slots;
+}
+
+unsigned int Entity::allocate()
+{
+	assert_not_parallel();
+	EntitySlots& s = slots();
+	unsigned int index;
+	if (!s.free_list.empty()) {
+		index = s.free_list.back();
+		s.free_list.pop_back();
+	}
+	else {
+		index = (unsigned int)s.generations.size();
+		assert(index <= ENTITY_INDEX_MASK && "Ran out of entity slots");
+		s.generations.push_back(0);
+		s.signatures.push_back(0);
+	}
+	return (s.generations[index] << ENTITY_INDEX_BITS) | index;
+}
+
+bool Entity::valid(Entity e)
+{
+	EntitySlots& s = slots();
+	return e.index() != 0 && e.index() < s.generations.size() && s.generations[e.index()] == e.generation();
+}
+
+void Entity::destroy(Entity e)
+{
+	assert_not_parallel();
+	if (!valid(e))
+		return;
+	EntitySlots& s = slots();
+	s.generations[e.index()] = (s.generations[e.index()] + 1) & ENTITY_GENERATION_MASK;
+	s.signatures[e.index()] = 0;
+	s.free_list.push_back(e.index());
+}
+
+void Entity::destroy_all()
+{
+	assert_not_parallel();
+	EntitySlots& s = slots();
+	s.free_list.clear();
+	// pushed from the back so the lowest slots are handed out first again
+	for (unsigned int index = (unsigned int)s.generations.size() - 1; index > 0; index--) {
+		s.generations[index] = (s.generations[index] + 1) & ENTITY_GENERATION_MASK;
+		s.signatures[index] = 0;
+		s.free_list.push_back(index);
+	}
+}
+
+ComponentSignature& Entity::signature(Entity e)
+{
+	return slots().signatures[e.index()];
+}
+
+void Entity::save_slots(EntitySlots& out)
+{
+	out = slots();
+}
+
+void Entity::restore_slots(const EntitySlots& in)
+{
+	assert_not_parallel();
+	EntitySlots& s = slots();
+	// slots that are free in the snapshot may have been handed out since, they keep the current generation,
+	// bumped when still in use, so handles created after the snapshot stay stale
+	std::vector<bool> free_now(s.generations.size(), false);
+	for (unsigned int index : s.free_list)
+		free_now[index] = true;
+	std::vector<unsigned int> current = s.generations;
+	s = in;
+	for (unsigned int index : in.free_list) {
+		if (index < current.size())
+			s.generations[index] = free_now[index] ? current[index] : (current[index] + 1) & ENTITY_GENERATION_MASK;
+	}
+	// slots handed out after the snapshot stay around as free slots, bumped the same way
+	for (unsigned int index = (unsigned int)in.generations.size(); index < current.size(); index++) {
+		s.free_list.push_back(index);
+		s.generations.push_back(free_now[index] ? current[index] : (current[index] + 1) & ENTITY_GENERATION_MASK);
+		s.signatures.push_back(0);
+	}
+}
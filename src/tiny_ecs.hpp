@@ -6,28 +6,81 @@
 
 #include <algorithm>
 #include <vector>
+#include <string>
 #include <unordered_map>
 #include <set>
 #include <functional>
 #include <typeindex>
+#include <tuple>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+#include <cstring>
 #include <assert.h>
 #include <glm/glm.hpp>
 
+#include "worker_pool.hpp"
 
 
+
+// Entity ids pack a slot index (low bits) and a generation (high bits)
+const unsigned int ENTITY_INDEX_BITS = 20;
+const unsigned int ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+const unsigned int ENTITY_GENERATION_MASK = (1u << (32 - ENTITY_INDEX_BITS)) - 1;
+
+// One bit per registered component container, set while the entity owns that component
+typedef unsigned long long ComponentSignature;
+const unsigned int MAX_COMPONENT_TYPES = 64;
+const unsigned int NO_SIGNATURE_BIT = 0xFFFFFFFF;
+
+// The generation and component signature of every entity slot and the slots free for re-use
+struct EntitySlots
+{
+	std::vector<unsigned int> generations;
+	std::vector<ComponentSignature> signatures;
+	std::vector<unsigned int> free_list;
+
+	EntitySlots()
+	{
+		// slot 0 is never handed out, entity 0 is the default initialization
+		generations.push_back(0);
+		signatures.push_back(0);
+	}
+};
+
 // Unique identifyer for all entities
 class Entity
 {
 	unsigned int id;
-	static unsigned int id_count; // starts from 1, entit 0 is the default initialization
 public:
-	Entity()
+	// The null handle, never valid; use Entity::create() for a new entity
+	Entity() : id(0) {}
+	// Hands out a new entity
+	// Note, slots of destroyed entities are re-used with a bumped generation, so stale handles never match a new entity
+	static Entity create()
 	{
-		id = id_count++;
-		// Note, indices of already deleted entities arent re-used in this simple implementation.
+		Entity e;
+		e.id = allocate();
+		return e;
 	}
-	operator unsigned int() { return id; } // this enables automatic casting to int
+	operator unsigned int() const { return id; } // this enables automatic casting to int
 	unsigned int getId() const { return id; } //gets ID
+	unsigned int index() const { return id & ENTITY_INDEX_MASK; }
+	unsigned int generation() const { return id >> ENTITY_INDEX_BITS; }
+
+	// Slot allocation, see tiny_ecs.cpp
+	static unsigned int allocate();
+	// Returns false once the entity has been destroyed, even if its slot was re-used
+	static bool valid(Entity e);
+	// Releases the slot of e for re-use, stale handles to e become invalid
+	static void destroy(Entity e);
+	// Releases every slot, all handles handed out so far become invalid
+	static void destroy_all();
+	// The component signature of the slot of e, only meaningful while e is valid
+	static ComponentSignature& signature(Entity e);
+	// Copies the whole slot table into out, and puts it back, see ECSRegistry::snapshot()
+	static void save_slots(EntitySlots& out);
+	static void restore_slots(const EntitySlots& in);
 };
 
 // Common interface to refer to all containers in the ECS registry
@@ -37,19 +90,407 @@ struct ContainerInterface
 	virtual size_t size() = 0;
 	virtual void remove(Entity e) = 0;
 	virtual bool has(Entity entity) = 0;
+
+	// Bit of this container in the entity component signatures, assigned by the registry
+	unsigned int signature_bit = NO_SIGNATURE_BIT;
+};
+
+// Random access iterator over any array-like type with operator[]
+template <typename Array, typename Value>
+class indexed_iterator
+{
+	Array* array;
+	size_t i;
+public:
+	typedef std::random_access_iterator_tag iterator_category;
+	typedef Value value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef Value* pointer;
+	typedef Value& reference;
+
+	indexed_iterator(Array* array, size_t i) : array(array), i(i) {}
+	Value& operator*() const { return (*array)[i]; }
+	Value* operator->() const { return &(*array)[i]; }
+	Value& operator[](difference_type n) const { return (*array)[i + n]; }
+	indexed_iterator& operator++() { i++; return *this; }
+	indexed_iterator& operator--() { i--; return *this; }
+	indexed_iterator operator++(int) { indexed_iterator it = *this; i++; return it; }
+	indexed_iterator operator--(int) { indexed_iterator it = *this; i--; return it; }
+	indexed_iterator& operator+=(difference_type n) { i += n; return *this; }
+	indexed_iterator& operator-=(difference_type n) { i -= n; return *this; }
+	indexed_iterator operator+(difference_type n) const { return indexed_iterator(array, i + n); }
+	indexed_iterator operator-(difference_type n) const { return indexed_iterator(array, i - n); }
+	difference_type operator-(const indexed_iterator& other) const { return (difference_type)i - (difference_type)other.i; }
+	bool operator==(const indexed_iterator& other) const { return i == other.i; }
+	bool operator!=(const indexed_iterator& other) const { return i != other.i; }
+	bool operator<(const indexed_iterator& other) const { return i < other.i; }
+	bool operator>(const indexed_iterator& other) const { return i > other.i; }
+	bool operator<=(const indexed_iterator& other) const { return i <= other.i; }
+	bool operator>=(const indexed_iterator& other) const { return i >= other.i; }
+};
+
+// Dense component storage made of fixed-size pages
+// Growing only adds pages, so existing components are never moved or copied by an insert
+const unsigned int COMPONENT_PAGE_SIZE = 64;
+
+template <typename T>
+class ChunkedArray
+{
+	// every page is reserved to COMPONENT_PAGE_SIZE elements up front and never grows past it
+	std::vector<std::vector<T>> pages;
+	size_t count = 0;
+
+public:
+	typedef indexed_iterator<ChunkedArray, T> iterator;
+	typedef indexed_iterator<const ChunkedArray, const T> const_iterator;
+
+	T& operator[](size_t i) { return pages[i / COMPONENT_PAGE_SIZE][i % COMPONENT_PAGE_SIZE]; }
+	const T& operator[](size_t i) const { return pages[i / COMPONENT_PAGE_SIZE][i % COMPONENT_PAGE_SIZE]; }
+	T& back() { return (*this)[count - 1]; }
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	size_t capacity() const { return pages.size() * COMPONENT_PAGE_SIZE; }
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, count); }
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, count); }
+
+	// Allocates pages up front so the first n components never allocate
+	void reserve(size_t n)
+	{
+		while (capacity() < n) {
+			pages.emplace_back();
+			pages.back().reserve(COMPONENT_PAGE_SIZE);
+		}
+	}
+
+	void push_back(T&& value)
+	{
+		reserve(count + 1);
+		pages[count / COMPONENT_PAGE_SIZE].push_back(std::move(value));
+		count++;
+	}
+
+	void pop_back()
+	{
+		count--;
+		pages[count / COMPONENT_PAGE_SIZE].pop_back();
+	}
+
+	// Destroys all elements but keeps the pages for re-use
+	void clear()
+	{
+		for (std::vector<T>& page : pages)
+			page.clear();
+		count = 0;
+	}
+
+	// Copies the bytes of all elements to out, one memcpy per page. Only for trivially copyable T.
+	void copy_bytes(unsigned char* out) const
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "copy_bytes needs a trivially copyable type");
+		for (size_t p = 0; p * COMPONENT_PAGE_SIZE < count; p++)
+			std::memcpy(out + p * COMPONENT_PAGE_SIZE * sizeof(T), pages[p].data(), pages[p].size() * sizeof(T));
+	}
+
+	// Heap bytes held by the pages and the page table
+	size_t bytes() const
+	{
+		return pages.capacity() * sizeof(std::vector<T>) + pages.size() * COMPONENT_PAGE_SIZE * sizeof(T);
+	}
+
+	// Appends copies of first[0..n), a page at a time, which is a single memmove per page for trivially copyable T
+	void append(const T* first, size_t n)
+	{
+		reserve(count + n);
+		while (n > 0) {
+			std::vector<T>& page = pages[count / COMPONENT_PAGE_SIZE];
+			size_t k = std::min(n, (size_t)COMPONENT_PAGE_SIZE - page.size());
+			page.insert(page.end(), first, first + k);
+			first += k;
+			n -= k;
+			count += k;
+		}
+	}
+};
+
+// Storage for empty tag components, e.g. Obstacle or Midground: there is nothing to store, so it only counts
+// Every element is the same shared instance
+template <typename T>
+class TagArray
+{
+	size_t count = 0;
+	size_t reserved = 0;
+
+	static T& instance()
+	{
+		static T tag;
+		return tag;
+	}
+public:
+	typedef indexed_iterator<TagArray, T> iterator;
+	typedef indexed_iterator<const TagArray, const T> const_iterator;
+
+	T& operator[](size_t) { return instance(); }
+	const T& operator[](size_t) const { return instance(); }
+	T& back() { return instance(); }
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	size_t capacity() const { return std::max(count, reserved); }
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, count); }
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, count); }
+
+	void reserve(size_t n) { reserved = std::max(reserved, n); }
+	void push_back(T&&) { count++; }
+	void pop_back() { count--; }
+	void clear() { count = 0; }
+	size_t bytes() const { return 0; }
+	void copy_bytes(unsigned char*) const {}
+	void append(const T*, size_t n) { count += n; }
 };
 
+// Estimated heap memory owned by a value beyond its sizeof, overloaded for components holding strings or containers
+template <typename T>
+size_t heap_bytes(const T&)
+{
+	return 0;
+}
+inline size_t heap_bytes(const std::string& s)
+{
+	// short strings are stored inline
+	return s.capacity() > 15 ? s.capacity() + 1 : 0;
+}
+template <typename T>
+size_t heap_bytes(const std::vector<T>& v)
+{
+	size_t bytes = v.capacity() * sizeof(T);
+	for (const T& element : v)
+		bytes += heap_bytes(element);
+	return bytes;
+}
+template <typename K, typename V, typename H, typename E, typename A>
+size_t heap_bytes(const std::unordered_map<K, V, H, E, A>& m)
+{
+	// a bucket array plus one node (next pointer, cached hash, value) per element
+	size_t bytes = m.bucket_count() * sizeof(void*);
+	for (const auto& kv : m)
+		bytes += 2 * sizeof(void*) + sizeof(kv) + heap_bytes(kv.first) + heap_bytes(kv.second);
+	return bytes;
+}
+
+// Memory used by one ComponentContainer, see ECSRegistry::memory_report()
+struct ContainerMemory
+{
+	const char* type;
+	size_t element_size;
+	size_t size;
+	size_t peak_size;
+	size_t capacity;
+	size_t dense_bytes; // component pages and the entity array
+	size_t sparse_bytes; // entity -> index pages, plus the slot bits of tags
+	size_t tracking_bytes; // change tracking and listeners
+	size_t nested_bytes; // heap owned by the components themselves, e.g. strings and maps
+
+	size_t total() const { return dense_bytes + sparse_bytes + tracking_bytes + nested_bytes; }
+};
+
+// Hot/cold split: a component can declare a cold part, fields that per-frame loops rarely read
+// The container keeps cold parts in their own array parallel to the components, so loops over the components stream
+// only the hot fields, and container.cold(e) reads the rest on demand. Declare one with
+//	template <> struct cold_part<Enemy> { typedef EnemyInfo type; };
+struct NoColdPart {};
+template <typename Component>
+struct cold_part {
+	typedef NoColdPart type;
+};
+
+// Copy of a ComponentContainer's components and entities, see ECSRegistry::snapshot()
+// Trivially copyable components are kept as raw bytes, the others are copy-constructed one by one
+template <typename Component, bool Trivial = std::is_trivially_copyable<Component>::value>
+struct ContainerSnapshot
+{
+	std::vector<Component> components;
+	std::vector<typename cold_part<Component>::type> cold;
+	std::vector<Entity> entities;
+};
+template <typename Component>
+struct ContainerSnapshot<Component, true>
+{
+	std::vector<unsigned char> bytes;
+	std::vector<typename cold_part<Component>::type> cold;
+	std::vector<Entity> entities;
+};
+
+// Frame counter used to stamp component changes, advanced by ECSRegistry::end_frame()
+inline unsigned int& change_frame()
+{
+	static unsigned int frame = 1;
+	return frame;
+}
+
+// Number of parallel_for() ranges in progress
+// Work inside one may only touch the components it is handed, so adding or removing components,
+// creating or destroying entities and recording changes are all asserted against
+inline unsigned int& parallel_depth()
+{
+	static unsigned int depth = 0;
+	return depth;
+}
+
+inline void assert_not_parallel()
+{
+	assert(parallel_depth() == 0 && "Structural change of the registry inside a parallel region");
+}
+
+// Ranges smaller than this run on the calling thread
+const size_t PARALLEL_GRAIN = 1024;
+
+// Calls fn(begin, end) for chunks of [0, count) on the worker pool and waits for all of them
+// Nested calls run on the calling thread
+template <typename Func>
+void parallel_for(size_t count, Func fn, size_t grain = PARALLEL_GRAIN)
+{
+	if (parallel_depth() > 0) {
+		fn((size_t)0, count);
+		return;
+	}
+	parallel_depth()++;
+	workers().run(count, grain, fn);
+	parallel_depth()--;
+}
+
+// Sparse index pages are allocated lazily so that large, mostly unused entity id ranges stay cheap
+const unsigned int SPARSE_PAGE_SIZE = 1024;
+const unsigned int INVALID_COMPONENT_INDEX = 0xFFFFFFFF;
+
 // A container that stores components of type 'Component' and associated entities
-template <typename Component> // A component can be any class
+// Implemented as a sparse set: a paged sparse array maps entity -> dense index, so has() and get() are plain array reads
+// Empty tag types also keep a bit per entity slot, so has() is a single bit test; the sparse array still gives remove() and the
+// change tracking the dense position in O(1).
+template <typename Component, bool Tag = std::is_empty<Component>::value> // A component can be any class
 class ComponentContainer : public ContainerInterface
 {
 private:
-	// The hash map from Entity -> array index.
-	std::unordered_map<unsigned int, unsigned int> map_entity_componentID; // the entity is cast to uint to be hashable.
+	// The paged sparse array from Entity -> array index, empty pages are not allocated
+	std::vector<std::vector<unsigned int>> sparse;
+	// Tags only: one bit per entity slot, set while the slot owns the tag
+	std::vector<unsigned long long> tag_bits;
+
+	inline bool tag_bit(Entity e) const
+	{
+		unsigned int word = e.index() / 64;
+		return word < tag_bits.size() && ((tag_bits[word] >> (e.index() % 64)) & 1);
+	}
+	void set_tag_bit(Entity e, bool set)
+	{
+		unsigned int word = e.index() / 64;
+		if (word >= tag_bits.size())
+			tag_bits.resize(word + 1, 0);
+		if (set)
+			tag_bits[word] |= 1ull << (e.index() % 64);
+		else
+			tag_bits[word] &= ~(1ull << (e.index() % 64));
+	}
 	bool registered = false;
+
+	// Change tracking, parallel to components: the frame each component was last modified in and its position in changed_list
+	std::vector<unsigned int> changed_frames;
+	std::vector<unsigned int> changed_slots;
+	// Entities whose component changed since the last clear_changes(), each listed once
+	std::vector<Entity> changed_list;
+
+	// Listeners, called synchronously in the order they were connected
+	std::vector<std::function<void(Entity, Component&)>> construct_listeners;
+	std::vector<std::function<void(Entity, Component&)>> update_listeners;
+	std::vector<std::function<void(Entity, Component&)>> destroy_listeners;
+
+	void notify(const std::vector<std::function<void(Entity, Component&)>>& listeners, Entity e, Component& c)
+	{
+		for (const auto& listener : listeners)
+			listener(e, c);
+	}
+
+	// Records a change of the component at dense index cID
+	void record_change(unsigned int cID, Entity e)
+	{
+		assert_not_parallel();
+		changed_frames[cID] = change_frame();
+		if (changed_slots[cID] == INVALID_COMPONENT_INDEX) {
+			changed_slots[cID] = (unsigned int)changed_list.size();
+			changed_list.push_back(e);
+		}
+	}
+
+	void save_components(ContainerSnapshot<Component, true>& out) const
+	{
+		out.bytes.resize(components.size() * sizeof(Component));
+		components.copy_bytes(out.bytes.data());
+	}
+	void save_components(ContainerSnapshot<Component, false>& out) const
+	{
+		out.components.clear();
+		out.components.reserve(components.size());
+		for (const Component& c : components)
+			out.components.push_back(c);
+	}
+	void restore_components(const ContainerSnapshot<Component, true>& in)
+	{
+		components.append(reinterpret_cast<const Component*>(in.bytes.data()), in.bytes.size() / sizeof(Component));
+	}
+	void restore_components(const ContainerSnapshot<Component, false>& in)
+	{
+		components.append(in.components.data(), in.components.size());
+	}
+
+	// Drops the component at dense index cID from changed_list
+	void unlist_changed(unsigned int cID)
+	{
+		unsigned int slot = changed_slots[cID];
+		if (slot == INVALID_COMPONENT_INDEX)
+			return;
+		changed_list[slot] = changed_list.back();
+		changed_slots[index_of(changed_list[slot])] = slot;
+		changed_list.pop_back();
+		changed_slots[cID] = INVALID_COMPONENT_INDEX;
+	}
+
+	// Returns the sparse slot of entity e, allocating its page if needed
+	inline unsigned int& sparse_slot(Entity e)
+	{
+		unsigned int page = e.index() / SPARSE_PAGE_SIZE;
+		if (page >= sparse.size())
+			sparse.resize(page + 1);
+		if (sparse[page].empty())
+			sparse[page].assign(SPARSE_PAGE_SIZE, INVALID_COMPONENT_INDEX);
+		return sparse[page][e.index() % SPARSE_PAGE_SIZE];
+	}
+
+	// Points the index entry of entity e at dense index cID, or drops it
+	void set_index(Entity e, unsigned int cID)
+	{
+		if (Tag)
+			set_tag_bit(e, true);
+		sparse_slot(e) = cID;
+	}
+	void drop_index(Entity e)
+	{
+		if (Tag)
+			set_tag_bit(e, false);
+		sparse_slot(e) = INVALID_COMPONENT_INDEX;
+	}
 public:
-	// Container of all components of type 'Component'
-	std::vector<Component> components;
+	// Container of all components of type 'Component', paged so that references stay valid when other components are added
+	typename std::conditional<Tag, TagArray<Component>, ChunkedArray<Component>>::type components;
+
+	// Cold parts of the components at the same positions, see cold_part. Takes no memory without a declared cold part.
+	typedef typename cold_part<Component>::type Cold;
+	typename std::conditional<std::is_empty<Cold>::value, TagArray<Cold>, ChunkedArray<Cold>>::type cold_components;
 
 	// The corresponding entities
 	std::vector<Entity> entities;
@@ -59,15 +500,39 @@ public:
 	{
 	}
 
+	// Returns the position of entity e in components/entities, or INVALID_COMPONENT_INDEX
+	// The sparse array is indexed by slot, so a stale handle is rejected by comparing the full id
+	inline unsigned int index_of(Entity e) const
+	{
+		unsigned int page = e.index() / SPARSE_PAGE_SIZE;
+		if (page >= sparse.size() || sparse[page].empty())
+			return INVALID_COMPONENT_INDEX;
+		unsigned int cID = sparse[page][e.index() % SPARSE_PAGE_SIZE];
+		if (cID == INVALID_COMPONENT_INDEX || entities[cID].getId() != e.getId())
+			return INVALID_COMPONENT_INDEX;
+		return cID;
+	}
+
 	// Inserting a component c associated to entity e
 	inline Component& insert(Entity e, Component c, bool check_for_duplicates = true)
 	{
 		// Usually, every entity should only have one instance of each component type
 		assert(!(check_for_duplicates && has(e)) && "Entity already contained in ECS registry");
+		assert(Entity::valid(e) && "Adding a component to a destroyed entity");
+		assert_not_parallel();
 
-		map_entity_componentID[e] = (unsigned int)components.size();
+		set_index(e, (unsigned int)components.size());
 		components.push_back(std::move(c)); // the move enforces move instead of copy constructor
+		cold_components.push_back(Cold());
 		entities.push_back(e);
+		// a new component counts as changed
+		changed_frames.push_back(change_frame());
+		changed_slots.push_back((unsigned int)changed_list.size());
+		changed_list.push_back(e);
+		peak_size = std::max(peak_size, components.size());
+		if (signature_bit != NO_SIGNATURE_BIT)
+			Entity::signature(e) |= (ComponentSignature)1 << signature_bit;
+		notify(construct_listeners, e, components.back());
 		return components.back();
 	};
 
@@ -81,45 +546,223 @@ public:
 		return insert(e, Component(std::forward<Args>(args)...), false);
 	};
 
+	// Inserts a copy of c, and of its cold part, for each of the n entities in es, see Prefab
+	void insert_n(const Entity* es, size_t n, const Component& c, const Cold& cold = Cold())
+	{
+		reserve(components.size() + n);
+		for (size_t i = 0; i < n; i++) {
+			insert(es[i], c);
+			cold_components.back() = cold;
+		}
+	}
+
 	// A wrapper to return the component of an entity
 	Component& get(Entity e) {
 		assert(has(e) && "Entity not contained in ECS registry");
-		return components[map_entity_componentID[e]];
+		// every tag shares one instance, no need to look up the position
+		return components[Tag ? 0 : index_of(e)];
+	}
+
+	// The cold part of e's component, see cold_part
+	Cold& cold(Entity e) {
+		assert(has(e) && "Entity not contained in ECS registry");
+		return cold_components[std::is_empty<Cold>::value ? 0 : index_of(e)];
 	}
 
 	// Check if entity has a component of type 'Component'
+	// For tags the slot bit only has to be confirmed to still belong to this handle, components leave with their entity
 	bool has(Entity entity) {
-		return map_entity_componentID.count(entity) > 0;
+		if (Tag)
+			return tag_bit(entity) && Entity::valid(entity);
+		return index_of(entity) != INVALID_COMPONENT_INDEX;
+	}
+
+	// Returns the component of an entity for writing and records the change, see changed()
+	// on_update listeners are not called since the write happens afterwards, use patch() if they need to see it
+	Component& modify(Entity e) {
+		unsigned int cID = index_of(e);
+		assert(cID != INVALID_COMPONENT_INDEX && "Entity not contained in ECS registry");
+		record_change(cID, e);
+		return components[cID];
+	}
+
+	// Applies fn to the component of entity e, then records the change and calls the on_update listeners
+	template <typename Func>
+	Component& patch(Entity e, Func fn)
+	{
+		Component& c = get(e);
+		fn(c);
+		mark_changed(e);
+		return c;
+	}
+
+	// Records that the component of entity e was modified in the current frame and calls the on_update listeners
+	void mark_changed(Entity e)
+	{
+		unsigned int cID = index_of(e);
+		assert(cID != INVALID_COMPONENT_INDEX && "Entity not contained in ECS registry");
+		record_change(cID, e);
+		notify(update_listeners, e, components[cID]);
+	}
+
+	// Connect listeners called with the entity and its component right after it was inserted, after patch() or mark_changed(),
+	// and right before it is removed. Used to keep derived indexes up to date, listeners must not add or remove this component type.
+	void on_construct(std::function<void(Entity, Component&)> listener)
+	{
+		construct_listeners.push_back(std::move(listener));
+	}
+	void on_update(std::function<void(Entity, Component&)> listener)
+	{
+		update_listeners.push_back(std::move(listener));
+	}
+	void on_destroy(std::function<void(Entity, Component&)> listener)
+	{
+		destroy_listeners.push_back(std::move(listener));
+	}
+
+	// Check if the component of entity e was added or modified since the last clear_changes()
+	bool changed(Entity e)
+	{
+		unsigned int cID = index_of(e);
+		return cID != INVALID_COMPONENT_INDEX && changed_slots[cID] != INVALID_COMPONENT_INDEX;
+	}
+
+	// The frame the component of entity e was last added or modified in, systems that skip frames can compare it to their last run
+	unsigned int changed_frame(Entity e)
+	{
+		assert(has(e) && "Entity not contained in ECS registry");
+		return changed_frames[index_of(e)];
+	}
+
+	// Entities whose component was added or modified since the last clear_changes()
+	const std::vector<Entity>& changed_entities() const
+	{
+		return changed_list;
+	}
+
+	// Forget the recorded changes, the registry does this once per frame
+	void clear_changes()
+	{
+		for (Entity e : changed_list)
+			changed_slots[index_of(e)] = INVALID_COMPONENT_INDEX;
+		changed_list.clear();
 	}
 
 	// Remove an component and pack the container to re-use the empty space
 	void remove(Entity e)
 	{
-		if (has(e))
+		assert_not_parallel();
+		unsigned int cID = index_of(e);
+		if (cID != INVALID_COMPONENT_INDEX)
 		{
-			// Get the current position
-			int cID = map_entity_componentID[e];
+			notify(destroy_listeners, e, components[cID]);
+			unlist_changed(cID);
+			changed_frames[cID] = changed_frames.back();
+			changed_slots[cID] = changed_slots.back();
+			changed_frames.pop_back();
+			changed_slots.pop_back();
 
 			// Move the last element to position cID using the move operator
 			// Note, components[cID] = components.back() would trigger the copy instead of move operator
 			components[cID] = std::move(components.back());
+			cold_components[cID] = std::move(cold_components.back());
 			entities[cID] = entities.back(); // the entity is only a single index, copy it.
-			map_entity_componentID[entities.back()] = cID;
+			set_index(entities.back(), cID);
 
 			// Erase the old component and free its memory
-			map_entity_componentID.erase(e);
+			drop_index(e);
+			if (signature_bit != NO_SIGNATURE_BIT)
+				Entity::signature(e) &= ~((ComponentSignature)1 << signature_bit);
 			components.pop_back();
+			cold_components.pop_back();
 			entities.pop_back();
-			// Note, one could mark the id for re-use
 		}
 	};
 
 	// Remove all components of type 'Component'
 	void clear()
 	{
-		map_entity_componentID.clear();
+		assert_not_parallel();
+		if (!destroy_listeners.empty()) {
+			for (unsigned int i = 0; i < entities.size(); i++)
+				notify(destroy_listeners, entities[i], components[i]);
+		}
+		// keep the allocated pages around, only reset the entries that are in use
+		for (Entity e : entities) {
+			drop_index(e);
+			if (signature_bit != NO_SIGNATURE_BIT)
+				Entity::signature(e) &= ~((ComponentSignature)1 << signature_bit);
+		}
 		components.clear();
+		cold_components.clear();
 		entities.clear();
+		changed_frames.clear();
+		changed_slots.clear();
+		changed_list.clear();
+	}
+
+	// Copies the components and entities into out, re-using its buffers
+	void save(ContainerSnapshot<Component>& out) const
+	{
+		save_components(out);
+		if (!std::is_empty<Cold>::value)
+			out.cold.assign(cold_components.begin(), cold_components.end());
+		out.entities = entities;
+	}
+
+	// Replaces all components by the ones of a snapshot, restored components count as changed
+	// Listeners see on_destroy for the current and on_construct for the restored components.
+	// Signatures are not touched, they are restored with the entity slot table.
+	void restore(const ContainerSnapshot<Component>& in)
+	{
+		assert_not_parallel();
+		for (unsigned int i = 0; i < entities.size(); i++) {
+			if (!destroy_listeners.empty())
+				notify(destroy_listeners, entities[i], components[i]);
+			drop_index(entities[i]);
+		}
+		components.clear();
+		restore_components(in);
+		cold_components.clear();
+		cold_components.append(in.cold.data(), in.entities.size());
+		entities = in.entities;
+		changed_frames.assign(entities.size(), change_frame());
+		changed_slots.resize(entities.size());
+		changed_list = entities;
+		for (unsigned int i = 0; i < entities.size(); i++) {
+			set_index(entities[i], i);
+			changed_slots[i] = i;
+		}
+		peak_size = std::max(peak_size, components.size());
+		if (!construct_listeners.empty()) {
+			for (unsigned int i = 0; i < entities.size(); i++)
+				notify(construct_listeners, entities[i], components[i]);
+		}
+	}
+
+	// Bytes held by this container, nested_bytes walks every component so this is not meant to be called per frame
+	ContainerMemory memory() const
+	{
+		ContainerMemory report;
+		report.type = typeid(Component).name();
+		report.element_size = sizeof(Component) + (std::is_empty<Cold>::value ? 0 : sizeof(Cold));
+		report.size = components.size();
+		report.peak_size = peak_size;
+		report.capacity = components.capacity();
+		report.dense_bytes = components.bytes() + cold_components.bytes() + entities.capacity() * sizeof(Entity);
+		report.sparse_bytes = sparse.capacity() * sizeof(std::vector<unsigned int>);
+		for (const std::vector<unsigned int>& page : sparse)
+			report.sparse_bytes += page.capacity() * sizeof(unsigned int);
+		report.sparse_bytes += tag_bits.capacity() * sizeof(unsigned long long);
+		report.tracking_bytes = (changed_frames.capacity() + changed_slots.capacity()) * sizeof(unsigned int)
+			+ changed_list.capacity() * sizeof(Entity)
+			+ (construct_listeners.capacity() + update_listeners.capacity() + destroy_listeners.capacity()) * sizeof(std::function<void(Entity, Component&)>);
+		report.nested_bytes = 0;
+		for (const Component& c : components)
+			report.nested_bytes += heap_bytes(c);
+		for (const Cold& c : cold_components)
+			report.nested_bytes += heap_bytes(c);
+		return report;
 	}
 
 	// Report the number of components of type 'Component'
@@ -128,18 +771,246 @@ public:
 		return components.size();
 	}
 
+	// Pre-allocates storage for n components, e.g. for types spawned in waves or bursts
+	void reserve(size_t n)
+	{
+		components.reserve(n);
+		cold_components.reserve(n);
+		entities.reserve(n);
+		changed_frames.reserve(n);
+		changed_slots.reserve(n);
+	}
+
+	// Number of components that fit without allocating, this never shrinks so it is also the peak capacity
+	size_t capacity()
+	{
+		return components.capacity();
+	}
+
+	// Largest number of components held at once since the container was created
+	size_t peak_size = 0;
+
 	// Sort the components and associated entity assignment structures by the comparisonFunction, see std::sort
 	template <class Compare>
 	void sort(Compare comparisonFunction)
 	{
-		// First sort the entity list as desired
-		std::sort(entities.begin(), entities.end(), comparisonFunction);
-		// Now re-arrange the components (Note, creates a new vector, which may be slow! Not sure if in-place could be faster: https://stackoverflow.com/questions/63703637/how-to-efficiently-permute-an-array-in-place-using-stdswap)
-		std::vector<Component> components_new; components_new.reserve(components.size());
-		std::transform(entities.begin(), entities.end(), std::back_inserter(components_new), [&](Entity e) { return std::move(get(e)); }); // note, the get still uses the old hash map (on purpose!)
-		components = std::move(components_new); // note, we use move operations to not create unneccesary copies of objects, but memory is still allocated for the new vector
-		// Fill the new hashmap
+		// Sort positions rather than components, then move every component at most once
+		std::vector<unsigned int> order(entities.size());
+		for (unsigned int i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return comparisonFunction(entities[a], entities[b]); });
+		apply_permutation(order);
+	}
+
+	// Sort by a key computed once per entity, e.g. sort_by_key([](Entity e) { return depth(e); })
+	// With nearly_sorted, an insertion sort is used, which is close to O(n) when the order barely changed since the last sort
+	template <class KeyExtractor>
+	void sort_by_key(KeyExtractor key, bool nearly_sorted = false)
+	{
+		typedef decltype(key(std::declval<Entity>())) Key;
+		std::vector<std::pair<Key, unsigned int>> keys;
+		keys.reserve(entities.size());
+		for (unsigned int i = 0; i < entities.size(); i++)
+			keys.push_back({ key(entities[i]), i });
+
+		if (nearly_sorted) {
+			for (size_t i = 1; i < keys.size(); i++) {
+				std::pair<Key, unsigned int> current = std::move(keys[i]);
+				size_t j = i;
+				for (; j > 0 && current < keys[j - 1]; j--)
+					keys[j] = std::move(keys[j - 1]);
+				keys[j] = std::move(current);
+			}
+		}
+		else {
+			std::sort(keys.begin(), keys.end());
+		}
+
+		std::vector<unsigned int> order(keys.size());
+		for (size_t i = 0; i < keys.size(); i++)
+			order[i] = keys[i].second;
+		apply_permutation(order);
+	}
+
+private:
+	// Re-arranges components and entities in place so that position i holds what was at order[i]
+	// Follows each cycle of the permutation, so every component is moved once and nothing is allocated per component
+	void apply_permutation(std::vector<unsigned int>& order)
+	{
+		assert_not_parallel();
+		for (unsigned int i = 0; i < order.size(); i++) {
+			if (order[i] == i)
+				continue;
+			Component component = std::move(components[i]);
+			Cold cold_value = std::move(cold_components[i]);
+			Entity entity = entities[i];
+			unsigned int frame = changed_frames[i];
+			unsigned int slot = changed_slots[i];
+			unsigned int j = i;
+			while (order[j] != i) {
+				unsigned int next = order[j];
+				components[j] = std::move(components[next]);
+				cold_components[j] = std::move(cold_components[next]);
+				entities[j] = entities[next];
+				changed_frames[j] = changed_frames[next];
+				changed_slots[j] = changed_slots[next];
+				order[j] = j;
+				j = next;
+			}
+			components[j] = std::move(component);
+			cold_components[j] = std::move(cold_value);
+			entities[j] = entity;
+			changed_frames[j] = frame;
+			changed_slots[j] = slot;
+			order[j] = j;
+		}
+		// Fill the new sparse indices
 		for (unsigned int i = 0; i < entities.size(); i++)
-			map_entity_componentID[entities[i]] = i;
+			set_index(entities[i], i);
+	}
+};
+
+// A list of component types, used to define the registry and to parameterize views
+template <typename... Component>
+struct type_list {};
+
+// Compile-time position of Component in a type_list
+template <typename Component, typename List>
+struct type_list_index;
+template <typename Component, typename... Rest>
+struct type_list_index<Component, type_list<Component, Rest...>> : std::integral_constant<unsigned int, 0> {};
+template <typename Component, typename First, typename... Rest>
+struct type_list_index<Component, type_list<First, Rest...>>
+	: std::integral_constant<unsigned int, 1 + type_list_index<Component, type_list<Rest...>>::value> {};
+
+// One ComponentContainer per type of a type_list
+template <typename List>
+struct container_tuple;
+template <typename... Component>
+struct container_tuple<type_list<Component...>> {
+	typedef std::tuple<ComponentContainer<Component>...> type;
+};
+
+// Calls fn on every element of a tuple, unrolled at compile time so each call is statically dispatched
+template <typename Tuple, typename Func, size_t... I>
+void for_each_in_tuple(Tuple& tuple, Func& fn, std::index_sequence<I...>)
+{
+	int expand[] = { 0, (fn(std::get<I>(tuple)), 0)... };
+	(void)expand;
+}
+template <typename... T, typename Func>
+void for_each_in_tuple(std::tuple<T...>& tuple, Func fn)
+{
+	for_each_in_tuple(tuple, fn, std::index_sequence_for<T...>{});
+}
+
+// Marker for components a view should skip, e.g. registry.view<Motion>(exclude<Explosion>)
+template <typename... Component>
+struct exclude_t {};
+template <typename... Component>
+constexpr exclude_t<Component...> exclude{};
+
+// Marker for a view term that only matches entities whose component changed since the last frame, e.g. registry.view<Changed<Text>>()
+template <typename Component>
+struct Changed {};
+
+// How a view term maps to its container: the component type, the entities it can match and the membership test
+template <typename Term>
+struct view_term {
+	typedef Term component;
+	static const std::vector<Entity>& candidates(ComponentContainer<Term>& pool) { return pool.entities; }
+	static bool matches(ComponentContainer<Term>& pool, Entity e) { return pool.has(e); }
+};
+template <typename Component>
+struct view_term<Changed<Component>> {
+	typedef Component component;
+	static const std::vector<Entity>& candidates(ComponentContainer<Component>& pool) { return pool.changed_entities(); }
+	static bool matches(ComponentContainer<Component>& pool, Entity e) { return pool.changed(e); }
+};
+
+// Iterates all entities that have every Include component and none of the Exclude components
+// The smallest Include container drives the iteration, the others are only probed
+template <typename Include, typename Exclude>
+class View;
+
+template <typename... Include, typename... Exclude>
+class View<type_list<Include...>, type_list<Exclude...>>
+{
+	std::tuple<ComponentContainer<typename view_term<Include>::component>*...> pools;
+	std::tuple<ComponentContainer<Exclude>*...> filters;
+	const std::vector<Entity>* driver = nullptr;
+
+	template <typename Term>
+	ComponentContainer<typename view_term<Term>::component>& pool() const
+	{
+		return *std::get<ComponentContainer<typename view_term<Term>::component>*>(pools);
+	}
+
+	template <typename Term>
+	void consider()
+	{
+		const std::vector<Entity>& candidates = view_term<Term>::candidates(pool<Term>());
+		if (driver == nullptr || candidates.size() < driver->size())
+			driver = &candidates;
+	}
+public:
+	View(std::tuple<ComponentContainer<typename view_term<Include>::component>*...> pools, std::tuple<ComponentContainer<Exclude>*...> filters)
+		: pools(pools), filters(filters)
+	{
+		int expand[] = { 0, (consider<Include>(), 0)... };
+		(void)expand;
+	}
+
+	// Check if entity e is part of the view
+	bool contains(Entity e) const
+	{
+		bool included = true;
+		bool excluded = false;
+		int expand_include[] = { 0, (included = included && view_term<Include>::matches(pool<Include>(), e), 0)... };
+		int expand_exclude[] = { 0, (excluded = excluded || std::get<ComponentContainer<Exclude>*>(filters)->has(e), 0)... };
+		(void)expand_include;
+		(void)expand_exclude;
+		return included && !excluded;
+	}
+
+	// Returns the component of type Component of an entity in the view
+	template <typename Component>
+	Component& get(Entity e) const
+	{
+		return std::get<ComponentContainer<Component>*>(pools)->get(e);
+	}
+
+	// Upper bound on the number of entities in the view
+	size_t size_hint() const
+	{
+		return driver->size();
+	}
+
+	// Calls fn(entity, Include&...) for every entity in the view
+	// Iterates backwards, so fn may remove the current entity. Other removals should be deferred.
+	template <typename Func>
+	void each(Func fn) const
+	{
+		for (size_t i = driver->size(); i-- > 0;) {
+			if (i >= driver->size())
+				continue;
+			Entity e = (*driver)[i];
+			if (contains(e))
+				fn(e, pool<Include>().get(e)...);
+		}
+	}
+
+	// Like each(), but split across the worker pool, see parallel_for()
+	// fn runs concurrently for different entities, so it may only write to the components it is given
+	template <typename Func>
+	void par_each(Func fn, size_t grain = PARALLEL_GRAIN) const
+	{
+		parallel_for(driver->size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				Entity e = (*driver)[i];
+				if (contains(e))
+					fn(e, pool<Include>().get(e)...);
+			}
+		}, grain);
 	}
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <map>
+#include <array>
 
 #include "tiny_ecs.hpp"
 #include "components.hpp"
@@ -8,78 +9,182 @@
 #include "animation_system.hpp"
 #include "game_state_controller.hpp"
 
+// Every component type stored in the registry, the position in this list is the component id and signature bit
+// IMPORTANT: newly added components only need to be added here (and given a named accessor in ECSRegistry)
+typedef type_list<
+	Player, Dash, Enemy, Motion, Collision, Cooldown, Collectible, Trap, PhantomTrap, Damaged,
+	Damaging, DeathTimer, Invulnerable, Knockable, Knocker, Trappable, Stamina, MapTile, Obstacle, Mesh*,
+	Collected, SlideUp, HomingProjectile, Bow, Bounceable, Explosion, Particle, CollectibleBomb,
+	HealthBar, StaminaBar, Text, Jumper, Projectile, TargetArea, Attachment,
+	// Render components
+	RenderRequest, Background, Midground, Foreground, vec4, PointLight,
+	// Spawnable types
+	Boar, Barbarian, Archer, Bird, Wizard, Troll, Bomber, Heart, CollectibleTrap,
+	AnimationController,
+	// Menus and tutorials
+	PauseMenuComponent, HelpMenuComponent, TutorialComponent, EnemyTutorialComponents, CollectibleTutorialComponents
+> RegistryComponents;
+
+// Heap memory owned by components with strings or containers, see ECSRegistry::memory_report()
+inline size_t heap_bytes(const Text& text) { return heap_bytes(text.value) + heap_bytes(text.lineOffsets); }
+
+// Copy of every component container and the entity slot table, see ECSRegistry::snapshot()
+template <typename List>
+struct snapshot_tuple;
+template <typename... Component>
+struct snapshot_tuple<type_list<Component...>> {
+	typedef std::tuple<ContainerSnapshot<Component>...> type;
+};
+
+struct RegistrySnapshot
+{
+	EntitySlots slots;
+	snapshot_tuple<RegistryComponents>::type containers;
+};
+
 class ECSRegistry
 {
-	// Callbacks to remove a particular or all entities in the system
-	std::vector<ContainerInterface*> registry_list;
+	// One container per registered component type, iterated with for_each_container
+	container_tuple<RegistryComponents>::type containers;
+
+	// Structural changes queued by systems during a frame, applied in flush_deferred()
+	std::vector<Entity> deferred_destroys;
+	std::vector<std::pair<unsigned int, Entity>> deferred_removes; // (component id, entity)
+	std::vector<std::function<void()>> deferred_adds;
+
+	// Cleared when attachments are added or removed, see sort_attachments()
+	bool attachments_sorted = true;
+
+	// Number of entities attached directly to each entity slot, kept by the attachments listeners
+	// Lets children_of() skip the scan for the many entities that never have anything attached
+	std::vector<unsigned int> attachment_children;
+
+	// Number of attached ancestors of an attached entity
+	unsigned int attachment_depth(Entity e) {
+		unsigned int depth = 0;
+		for (Entity parent = attachments.get(e).parent; attachments.has(parent); parent = attachments.get(parent).parent) {
+			depth++;
+			assert(depth <= attachments.size() && "Attachment cycle");
+		}
+		return depth;
+	}
+
+public:
+	// Compile-time id of a component type, also its bit in the entity component signatures
+	template <typename Component>
+	static constexpr unsigned int component_id() {
+		return type_list_index<Component, RegistryComponents>::value;
+	}
+
+	// Returns the container holding components of type Component
+	template <typename Component>
+	ComponentContainer<Component>& container() {
+		return std::get<component_id<Component>()>(containers);
+	}
+
+	// Calls fn(container) for every container, statically dispatched
+	template <typename Func>
+	void for_each_container(Func fn) {
+		for_each_in_tuple(containers, fn);
+	}
+
+private:
+	template <size_t... I>
+	void save_containers(RegistrySnapshot& out, std::index_sequence<I...>) {
+		int expand[] = { 0, (std::get<I>(containers).save(std::get<I>(out.containers)), 0)... };
+		(void)expand;
+	}
+	template <size_t... I>
+	void restore_containers(const RegistrySnapshot& in, std::index_sequence<I...>) {
+		int expand[] = { 0, (std::get<I>(containers).restore(std::get<I>(in.containers)), 0)... };
+		(void)expand;
+	}
 
 public:
-	// constructor that adds all containers for looping over them
-	// IMPORTANT: Don't forget to add any newly added containers!
-	ComponentContainer<Player> players;
-	ComponentContainer<Dash> dashers;
-	ComponentContainer<Enemy> enemies;
-	ComponentContainer<Motion> motions;
-	ComponentContainer<Collision> collisions;
-	ComponentContainer<Cooldown> cooldowns;
-	ComponentContainer<Collectible> collectibles;
-	ComponentContainer<Trap> traps;
-	ComponentContainer<PhantomTrap> phantomTraps;
-	ComponentContainer<Damaged> damageds;
-	ComponentContainer<Damaging> damagings;
-	ComponentContainer<DeathTimer> deathTimers;
-	ComponentContainer<Invulnerable> invulnerables;
-	ComponentContainer<Knockable> knockables;
-	ComponentContainer<Knocker> knockers;
-	ComponentContainer<Trappable> trappables;
-	ComponentContainer<HealthBar> healthBars;
-	ComponentContainer<AnimationController> animationControllers;
-	ComponentContainer<StaminaBar> staminaBars;
-	ComponentContainer<Stamina> staminas;
-	ComponentContainer<Text> texts;
-	ComponentContainer<Jumper> jumpers;
-	ComponentContainer<MapTile> mapTiles;
-	ComponentContainer<Obstacle> obstacles;
-	ComponentContainer<Projectile> projectiles;
-	ComponentContainer<Mesh*> meshPtrs;
-	ComponentContainer<TargetArea> targetAreas;
-	ComponentContainer<Collected> collected;
-	ComponentContainer<SlideUp> slideUps;
-	ComponentContainer<HomingProjectile> homingProjectiles;
-	ComponentContainer<Bounceable> bounceables;
-	ComponentContainer<Explosion> explosions;
-	ComponentContainer<Particle> particles;
+	// Copies every container and the entity slot table into out, re-using its buffers so frequent checkpoints do not allocate
+	// Take it at a sync point, queued deferred changes are not part of the snapshot
+	void snapshot(RegistrySnapshot& out) {
+		Entity::save_slots(out.slots);
+		save_containers(out, std::make_index_sequence<std::tuple_size<decltype(containers)>::value>{});
+	}
+
+	// Puts the registry back into the state of a snapshot, handles to entities created since then become invalid
+	// State kept outside the containers (timer, score, inventory, UI) is not restored
+	void restore(const RegistrySnapshot& in) {
+		deferred_destroys.clear();
+		deferred_removes.clear();
+		deferred_adds.clear();
+		Entity::restore_slots(in.slots);
+		restore_containers(in, std::make_index_sequence<std::tuple_size<decltype(containers)>::value>{});
+	}
+
+	// Named accessors into the containers
+	ComponentContainer<Player>& players = container<Player>();
+	ComponentContainer<Dash>& dashers = container<Dash>();
+	ComponentContainer<Enemy>& enemies = container<Enemy>();
+	ComponentContainer<Motion>& motions = container<Motion>();
+	ComponentContainer<Collision>& collisions = container<Collision>();
+	ComponentContainer<Cooldown>& cooldowns = container<Cooldown>();
+	ComponentContainer<Collectible>& collectibles = container<Collectible>();
+	ComponentContainer<Trap>& traps = container<Trap>();
+	ComponentContainer<PhantomTrap>& phantomTraps = container<PhantomTrap>();
+	ComponentContainer<Damaged>& damageds = container<Damaged>();
+	ComponentContainer<Damaging>& damagings = container<Damaging>();
+	ComponentContainer<DeathTimer>& deathTimers = container<DeathTimer>();
+	ComponentContainer<Invulnerable>& invulnerables = container<Invulnerable>();
+	ComponentContainer<Knockable>& knockables = container<Knockable>();
+	ComponentContainer<Knocker>& knockers = container<Knocker>();
+	ComponentContainer<Trappable>& trappables = container<Trappable>();
+	ComponentContainer<HealthBar>& healthBars = container<HealthBar>();
+	ComponentContainer<AnimationController>& animationControllers = container<AnimationController>();
+	ComponentContainer<StaminaBar>& staminaBars = container<StaminaBar>();
+	ComponentContainer<Attachment>& attachments = container<Attachment>();
+	ComponentContainer<Stamina>& staminas = container<Stamina>();
+	ComponentContainer<Text>& texts = container<Text>();
+	ComponentContainer<Jumper>& jumpers = container<Jumper>();
+	ComponentContainer<MapTile>& mapTiles = container<MapTile>();
+	ComponentContainer<Obstacle>& obstacles = container<Obstacle>();
+	ComponentContainer<Projectile>& projectiles = container<Projectile>();
+	ComponentContainer<Mesh*>& meshPtrs = container<Mesh*>();
+	ComponentContainer<TargetArea>& targetAreas = container<TargetArea>();
+	ComponentContainer<Collected>& collected = container<Collected>();
+	ComponentContainer<SlideUp>& slideUps = container<SlideUp>();
+	ComponentContainer<HomingProjectile>& homingProjectiles = container<HomingProjectile>();
+	ComponentContainer<Bounceable>& bounceables = container<Bounceable>();
+	ComponentContainer<Explosion>& explosions = container<Explosion>();
+	ComponentContainer<Particle>& particles = container<Particle>();
 	
-	ComponentContainer<PauseMenuComponent> pauseMenuComponents;
-	ComponentContainer<HelpMenuComponent> helpMenuComponents;
-	ComponentContainer<TutorialComponent> tutorialComponents;
-	ComponentContainer<EnemyTutorialComponents> enemyTutorialComponents;
-	ComponentContainer<CollectibleTutorialComponents> collectibleTutorialComponents;
+	ComponentContainer<PauseMenuComponent>& pauseMenuComponents = container<PauseMenuComponent>();
+	ComponentContainer<HelpMenuComponent>& helpMenuComponents = container<HelpMenuComponent>();
+	ComponentContainer<TutorialComponent>& tutorialComponents = container<TutorialComponent>();
+	ComponentContainer<EnemyTutorialComponents>& enemyTutorialComponents = container<EnemyTutorialComponents>();
+	ComponentContainer<CollectibleTutorialComponents>& collectibleTutorialComponents = container<CollectibleTutorialComponents>();
 
 	std::map<char, TextChar> textChars; //for initializing text glyphs from freetypes
 
 	// Render component containers
-	ComponentContainer<RenderRequest> renderRequests;
-	ComponentContainer<Background> backgrounds;
-	ComponentContainer<Midground> midgrounds;
-	ComponentContainer<Foreground> foregrounds;
-	ComponentContainer<vec4> colours;
-	ComponentContainer<PointLight> pointLights;
+	ComponentContainer<RenderRequest>& renderRequests = container<RenderRequest>();
+	ComponentContainer<Background>& backgrounds = container<Background>();
+	ComponentContainer<Midground>& midgrounds = container<Midground>();
+	ComponentContainer<Foreground>& foregrounds = container<Foreground>();
+	ComponentContainer<vec4>& colours = container<vec4>();
+	ComponentContainer<PointLight>& pointLights = container<PointLight>();
 
 
 	// Spawnable types
-	std::unordered_map<std::string, ContainerInterface*> spawnable_lists;
-	ComponentContainer<Boar> boars;
-	ComponentContainer<Barbarian> barbarians;
-	ComponentContainer<Archer> archers;
-	ComponentContainer<Bird> birds;
-	ComponentContainer<Wizard> wizards;
-	ComponentContainer<Troll> trolls;
-	ComponentContainer<Bomber> bombers;
-	ComponentContainer<Heart> hearts;
-	ComponentContainer<Bow> bows;
-	ComponentContainer<CollectibleTrap> collectibleTraps;
-	ComponentContainer<CollectibleBomb> collectibleBombs;
+	// Number of live entities per spawnable type, kept up to date by listeners on the containers
+	std::array<int, spawnable_type_count> spawn_counts = {};
+	ComponentContainer<Boar>& boars = container<Boar>();
+	ComponentContainer<Barbarian>& barbarians = container<Barbarian>();
+	ComponentContainer<Archer>& archers = container<Archer>();
+	ComponentContainer<Bird>& birds = container<Bird>();
+	ComponentContainer<Wizard>& wizards = container<Wizard>();
+	ComponentContainer<Troll>& trolls = container<Troll>();
+	ComponentContainer<Bomber>& bombers = container<Bomber>();
+	ComponentContainer<Heart>& hearts = container<Heart>();
+	ComponentContainer<Bow>& bows = container<Bow>();
+	ComponentContainer<CollectibleTrap>& collectibleTraps = container<CollectibleTrap>();
+	ComponentContainer<CollectibleBomb>& collectibleBombs = container<CollectibleBomb>();
 
 	GameTimer gameTimer;
 	GameScore gameScore;
@@ -91,100 +196,274 @@ public:
 
 	ECSRegistry()
 	{
-		registry_list.push_back(&players);
-		registry_list.push_back(&dashers);
-		registry_list.push_back(&enemies);
-		registry_list.push_back(&motions);
-		registry_list.push_back(&collisions);
-		registry_list.push_back(&cooldowns);
-		registry_list.push_back(&collectibles);
-		registry_list.push_back(&traps);
-		registry_list.push_back(&phantomTraps);
-		registry_list.push_back(&damageds);
-		registry_list.push_back(&damagings);
-		registry_list.push_back(&deathTimers);
-		registry_list.push_back(&invulnerables);
-		registry_list.push_back(&knockables);
-		registry_list.push_back(&knockers);
-		registry_list.push_back(&trappables);
-		registry_list.push_back(&staminas);
-		registry_list.push_back(&mapTiles);
-		registry_list.push_back(&obstacles);
-		registry_list.push_back(&meshPtrs);
-		registry_list.push_back(&collected);
-		registry_list.push_back(&slideUps);
-		registry_list.push_back(&homingProjectiles);
-		registry_list.push_back(&bows);
-		registry_list.push_back(&bounceables);
-		registry_list.push_back(&explosions);
-		registry_list.push_back(&particles);
-		registry_list.push_back(&collectibleBombs);
-		
-		registry_list.push_back(&healthBars);
-		registry_list.push_back(&staminaBars);
-		registry_list.push_back(&texts);
-		registry_list.push_back(&jumpers);
-		registry_list.push_back(&projectiles);
-		registry_list.push_back(&targetAreas);
-
-		registry_list.push_back(&renderRequests);
-		registry_list.push_back(&backgrounds);
-		registry_list.push_back(&midgrounds);
-		registry_list.push_back(&foregrounds);
-		registry_list.push_back(&colours);
-		registry_list.push_back(&pointLights);
-
-		registry_list.push_back(&boars);
-		registry_list.push_back(&barbarians);
-		registry_list.push_back(&archers);
-		registry_list.push_back(&birds);
-		registry_list.push_back(&wizards);
-		registry_list.push_back(&trolls);
-		registry_list.push_back(&bombers);
-		registry_list.push_back(&hearts);
-		registry_list.push_back(&collectibleTraps);
-
-		registry_list.push_back(&animationControllers);
-
-		registry_list.push_back(&pauseMenuComponents);
-		registry_list.push_back(&helpMenuComponents);
-		registry_list.push_back(&tutorialComponents);
-		registry_list.push_back(&enemyTutorialComponents);
-		registry_list.push_back(&collectibleTutorialComponents);
-
-		spawnable_lists["boar"] = &boars;
-		spawnable_lists["barbarian"] = &barbarians;
-		spawnable_lists["archer"] = &archers;
-		spawnable_lists["bird"] = &birds;
-		spawnable_lists["wizard"] = &wizards;
-		spawnable_lists["troll"] = &trolls;
-		spawnable_lists["bomber"] = &bombers;
-		spawnable_lists["heart"] = &hearts;
-		spawnable_lists["collectible_trap"] = &collectibleTraps;
+		static_assert(std::tuple_size<container_tuple<RegistryComponents>::type>::value <= MAX_COMPONENT_TYPES,
+			"Too many component types for ComponentSignature");
+
+		// every container's signature bit is its component id
+		unsigned int id = 0;
+		for_each_container([&](ContainerInterface& container) {
+			container.signature_bit = id++;
+		});
+
+		// Initial capacities of the types created in particle bursts and spawn waves, so the first waves never allocate
+		particles.reserve(512);
+		motions.reserve(512);
+		renderRequests.reserve(512);
+		midgrounds.reserve(256);
+		colours.reserve(256);
+		enemies.reserve(128);
+		healthBars.reserve(128);
+		animationControllers.reserve(128);
+		trappables.reserve(128);
+		knockables.reserve(128);
+
+		count_spawnable<Boar>(SPAWNABLE_TYPE::BOAR);
+		count_spawnable<Barbarian>(SPAWNABLE_TYPE::BARBARIAN);
+		count_spawnable<Archer>(SPAWNABLE_TYPE::ARCHER);
+		count_spawnable<Bird>(SPAWNABLE_TYPE::BIRD);
+		count_spawnable<Wizard>(SPAWNABLE_TYPE::WIZARD);
+		count_spawnable<Troll>(SPAWNABLE_TYPE::TROLL);
+		count_spawnable<Bomber>(SPAWNABLE_TYPE::BOMBER);
+		count_spawnable<Heart>(SPAWNABLE_TYPE::HEART);
+		count_spawnable<CollectibleTrap>(SPAWNABLE_TYPE::COLLECTIBLE_TRAP);
+
+		attachments.on_construct([this](Entity, Attachment& attachment) {
+			attachments_sorted = false;
+			unsigned int slot = attachment.parent.index();
+			if (slot >= attachment_children.size())
+				attachment_children.resize(slot + 1, 0);
+			attachment_children[slot]++;
+		});
+		// removing swaps the last attachment into the gap, which can put a child before its parent
+		attachments.on_destroy([this](Entity, Attachment& attachment) {
+			attachments_sorted = false;
+			attachment_children[attachment.parent.index()]--;
+		});
 	}
 
+	// Keeps spawn_counts[type] equal to the number of Component instances
+	template <typename Component>
+	void count_spawnable(SPAWNABLE_TYPE type)
+	{
+		int& count = spawn_counts[(int)type]; // the registry is never moved, so this stays valid
+		count = 0;
+		container<Component>().on_construct([&count](Entity, Component&) { count++; });
+		container<Component>().on_destroy([&count](Entity, Component&) { count--; });
+	}
+
+	// Removes every component and releases every entity slot, so no handle from before the clear stays valid
 	void clear_all_components() {
-		for (ContainerInterface* reg : registry_list)
-			reg->clear();
+		for_each_container([](auto& container) {
+			container.clear();
+		});
+		Entity::destroy_all();
+		// queued changes refer to entities that no longer exist
+		deferred_destroys.clear();
+		deferred_removes.clear();
+		deferred_adds.clear();
 	}
 
 	void list_all_components() {
 		printf("Debug info on all registry entries:\n");
-		for (ContainerInterface* reg : registry_list)
-			if (reg->size() > 0)
-				printf("%4d components of type %s\n", (int)reg->size(), typeid(*reg).name());
+		for_each_container([](auto& container) {
+			if (container.size() > 0)
+				printf("%4d components (peak %4d, capacity %4d) of type %s\n", (int)container.size(),
+					(int)container.peak_size, (int)container.capacity(), typeid(container).name());
+		});
+	}
+
+	// Memory used by every container, in component id order
+	std::vector<ContainerMemory> memory_report() {
+		std::vector<ContainerMemory> report;
+		for_each_container([&](auto& container) {
+			report.push_back(container.memory());
+		});
+		return report;
+	}
+
+	// Prints memory_report() for the containers that hold or held components, plus the totals
+	void print_memory_report() {
+		printf("Memory used by the registry (bytes):\n");
+		printf("%8s %6s %6s %6s %10s %8s %8s %8s %10s  %s\n", "elem", "size", "peak", "cap", "dense", "sparse", "track", "nested", "total", "type");
+		ContainerMemory sum = {};
+		for (const ContainerMemory& c : memory_report()) {
+			sum.dense_bytes += c.dense_bytes;
+			sum.sparse_bytes += c.sparse_bytes;
+			sum.tracking_bytes += c.tracking_bytes;
+			sum.nested_bytes += c.nested_bytes;
+			if (c.peak_size == 0)
+				continue;
+			printf("%8d %6d %6d %6d %10d %8d %8d %8d %10d  %s\n", (int)c.element_size, (int)c.size, (int)c.peak_size, (int)c.capacity,
+				(int)c.dense_bytes, (int)c.sparse_bytes, (int)c.tracking_bytes, (int)c.nested_bytes, (int)c.total(), c.type);
+		}
+		printf("%8s %6s %6s %6s %10d %8d %8d %8d %10d  %s\n", "", "", "", "", (int)sum.dense_bytes, (int)sum.sparse_bytes,
+			(int)sum.tracking_bytes, (int)sum.nested_bytes, (int)sum.total(), "all containers");
 	}
 
 	void list_all_components_of(Entity e) {
 		printf("Debug info on components of entity %u:\n", (unsigned int)e);
-		for (ContainerInterface* reg : registry_list)
-			if (reg->has(e))
-				printf("type %s\n", typeid(*reg).name());
+		ComponentSignature owned = signature(e);
+		for_each_container([&](ContainerInterface& container) {
+			if (owned & ((ComponentSignature)1 << container.signature_bit))
+				printf("type %s\n", typeid(container).name());
+		});
+	}
+
+	// Attaches child to parent, see Attachment
+	// The parent is set before inserting so the listeners see it, it must not be changed afterwards
+	Attachment& attach(Entity child, Entity parent, vec3 offset, bool aboveParent = false) {
+		Attachment attachment;
+		attachment.parent = parent;
+		attachment.offset = offset;
+		attachment.aboveParent = aboveParent;
+		return attachments.insert(child, attachment);
+	}
+
+	// Appends the entities attached directly to e
+	// Entities without children return right away, the others scan all attachments of the world
+	void children_of(Entity e, std::vector<Entity>& out) {
+		if (e.index() >= attachment_children.size() || attachment_children[e.index()] == 0)
+			return;
+		for (size_t i = 0; i < attachments.size(); i++)
+			if (attachments.components[i].parent == e)
+				out.push_back(attachments.entities[i]);
+	}
+
+	// Destroys everything attached to e, directly or through other attachments
+	void destroy_children(Entity e) {
+		std::vector<Entity> children;
+		children_of(e, children);
+		for (Entity child : children)
+			remove_all_components_of(child);
+	}
+
+	// Orders the attachments so that every parent comes before its children
+	// Only sorts after attachments were added or removed
+	void sort_attachments() {
+		if (attachments_sorted)
+			return;
+		attachments.sort_by_key([this](Entity e) { return attachment_depth(e); }, true);
+		attachments_sorted = true;
 	}
 
+	// Removes every component of e and releases its slot, so stored handles to e stop being valid
+	// Only the containers set in the signature of e do any work. Entities attached to e are destroyed as well.
 	void remove_all_components_of(Entity e) {
-		for (ContainerInterface* reg : registry_list)
-			reg->remove(e);
+		if (!Entity::valid(e))
+			return;
+		destroy_children(e);
+		ComponentSignature owned = Entity::signature(e);
+		for_each_container([&](auto& container) {
+			if (owned & ((ComponentSignature)1 << container.signature_bit))
+				container.remove(e);
+		});
+		Entity::destroy(e);
+	}
+
+	// The set of components owned by e, one bit per container (see ContainerInterface::signature_bit)
+	ComponentSignature signature(Entity e) {
+		return Entity::valid(e) ? Entity::signature(e) : 0;
+	}
+
+	// Queue the destruction of e, it keeps all its components until flush_deferred()
+	// Use this instead of remove_all_components_of while iterating a container
+	void destroy_deferred(Entity e) {
+		assert_not_parallel();
+		deferred_destroys.push_back(e);
+	}
+
+	// Queue the removal of the Component of e
+	template <typename Component>
+	void remove_deferred(Entity e) {
+		assert_not_parallel();
+		deferred_removes.push_back({ component_id<Component>(), e });
+	}
+
+	// Queue adding component c to e, dropped if e is destroyed before the flush
+	template <typename Component>
+	void emplace_deferred(Entity e, Component c) {
+		assert_not_parallel();
+		ComponentContainer<Component>* target = &container<Component>();
+		deferred_adds.push_back([target, e, c]() {
+			if (Entity::valid(e) && !target->has(e))
+				target->insert(e, c);
+		});
+	}
+
+	// Sync point: applies all queued changes in one batch, grouped by container
+	void flush_deferred() {
+		// entities attached to a destroyed one go with it, the list grows while it is walked so whole chains are covered
+		if (attachments.size() > 0) {
+			for (size_t i = 0; i < deferred_destroys.size(); i++)
+				children_of(deferred_destroys[i], deferred_destroys);
+		}
+
+		// destroying an entity is removing each of its components, then releasing its slot
+		for (Entity e : deferred_destroys) {
+			if (!Entity::valid(e))
+				continue;
+			ComponentSignature owned = Entity::signature(e);
+			for (unsigned int i = 0; owned != 0; i++, owned >>= 1)
+				if (owned & 1)
+					deferred_removes.push_back({ i, e });
+		}
+
+		std::sort(deferred_removes.begin(), deferred_removes.end(),
+			[](const std::pair<unsigned int, Entity>& a, const std::pair<unsigned int, Entity>& b) {
+				return a.first != b.first ? a.first < b.first : a.second.index() < b.second.index();
+			});
+		size_t next = 0;
+		for_each_container([&](auto& container) {
+			for (; next < deferred_removes.size() && deferred_removes[next].first == container.signature_bit; next++)
+				container.remove(deferred_removes[next].second);
+		});
+
+		for (Entity e : deferred_destroys)
+			Entity::destroy(e);
+
+		for (auto& add : deferred_adds)
+			add();
+
+		deferred_destroys.clear();
+		deferred_removes.clear();
+		deferred_adds.clear();
+	}
+
+	// Entities with all Include components and none of the Exclude ones, e.g. view<Motion, Projectile>() or view<Motion>(exclude<Explosion>)
+	// An Include term Changed<C> only matches entities whose C changed this frame, e.g. view<Changed<Text>>()
+	template <typename... Include, typename... Exclude>
+	View<type_list<Include...>, type_list<Exclude...>> view(exclude_t<Exclude...> = {}) {
+		return View<type_list<Include...>, type_list<Exclude...>>(
+			std::make_tuple(&container<typename view_term<Include>::component>()...), std::make_tuple(&container<Exclude>()...));
+	}
+
+	// Calls fn(entity, component) for every Component, split into chunks that run on the worker pool
+	// fn runs concurrently for different components, so it may only write to the one it is given.
+	// Anything structural (creating entities, adding, removing or deferring) has to happen after the call.
+	template <typename Component, typename Func>
+	void par_for_each(Func fn, size_t grain = PARALLEL_GRAIN) {
+		ComponentContainer<Component>& pool = container<Component>();
+		parallel_for(pool.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++)
+				fn(pool.entities[i], pool.components[i]);
+		}, grain);
+	}
+
+	// Forgets this frame's component changes and advances the frame counter, called once per frame after drawing
+	void end_frame()
+	{
+		for_each_container([](auto& container) { container.clear_changes(); });
+		change_frame()++;
+	}
+
+	// Check if e owns every component in required, e.g. for archetype-style queries
+	bool has_all(Entity e, ComponentSignature required) {
+		return (signature(e) & required) == required;
+	}
+
+	// Check if e still refers to a live entity, O(1)
+	bool valid(Entity e) {
+		return Entity::valid(e);
 	}
 };
 
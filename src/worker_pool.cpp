@@ -0,0 +1,101 @@
+// internal
+#include "worker_pool.hpp"
+
+// stlib
+#include <algorithm>
+#include <memory>
+
+WorkerPool::WorkerPool(unsigned int worker_count)
+{
+	for (unsigned int i = 0; i < worker_count; i++)
+		threads.emplace_back([this]() { work(); });
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+void WorkerPool::run(size_t count, size_t grain, const std::function<void(size_t, size_t)>& job)
+{
+	if (count == 0)
+		return;
+	// Not worth waking anyone up
+	if (threads.empty() || count <= grain) {
+		job(0, count);
+		return;
+	}
+
+	std::lock_guard<std::mutex> run_lock(run_mutex);
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		// a worker may still be leaving the previous range
+		done.wait(lock, [&]() { return busy == 0; });
+		// a few chunks per thread, so a slow chunk does not hold everyone up
+		size_t chunks = std::min((size_t)(threads.size() + 1) * 4, (count + grain - 1) / grain);
+		this->job = &job;
+		this->count = count;
+		chunk_size = (count + chunks - 1) / chunks;
+		chunk_count = (count + chunk_size - 1) / chunk_size;
+		next_chunk = 0;
+		generation++;
+	}
+	wake.notify_all();
+
+	run_chunks();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [&]() { return busy == 0; });
+	this->job = nullptr;
+}
+
+void WorkerPool::work()
+{
+	unsigned int seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [&]() { return stopping || generation != seen; });
+		if (stopping)
+			return;
+		seen = generation;
+		busy++;
+		lock.unlock();
+		run_chunks();
+		lock.lock();
+		if (--busy == 0)
+			done.notify_all();
+	}
+}
+
+void WorkerPool::run_chunks()
+{
+	for (size_t chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++) {
+		size_t begin = chunk * chunk_size;
+		(*job)(begin, std::min(begin + chunk_size, count));
+	}
+}
+
+static std::unique_ptr<WorkerPool>& shared_pool()
+{
+	static std::unique_ptr<WorkerPool> pool;
+	return pool;
+}
+
+WorkerPool& workers()
+{
+	std::unique_ptr<WorkerPool>& pool = shared_pool();
+	if (!pool)
+		pool.reset(new WorkerPool(std::max(std::thread::hardware_concurrency(), 1u) - 1));
+	return *pool;
+}
+
+void set_worker_count(unsigned int worker_count)
+{
+	shared_pool().reset(new WorkerPool(worker_count));
+}
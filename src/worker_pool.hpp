@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// A fixed set of threads that split index ranges between them, see parallel_for() in tiny_ecs.hpp
+// The calling thread works on chunks as well, so a pool of N workers runs N + 1 chunks at once
+class WorkerPool
+{
+public:
+	explicit WorkerPool(unsigned int worker_count);
+	~WorkerPool();
+
+	// Calls job(begin, end) for chunks of [0, count) no smaller than grain, and returns when all of them are done
+	// Only one range runs at a time, concurrent callers wait for each other
+	void run(size_t count, size_t grain, const std::function<void(size_t, size_t)>& job);
+
+	unsigned int size() const { return (unsigned int)threads.size(); }
+
+private:
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::mutex run_mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	bool stopping = false;
+	unsigned int generation = 0; // bumped for every range, workers wake up when it changes
+	unsigned int busy = 0; // workers that are between picking up a range and finishing it
+
+	// The current range, written under mutex while no worker is busy
+	const std::function<void(size_t, size_t)>* job = nullptr;
+	size_t count = 0;
+	size_t chunk_size = 0;
+	size_t chunk_count = 0;
+	std::atomic<size_t> next_chunk{ 0 };
+
+	void work();
+	void run_chunks();
+};
+
+// The pool shared by the game's systems, one worker per hardware thread besides the main thread
+WorkerPool& workers();
+
+// Replaces the shared pool with one of worker_count threads, e.g. to measure scaling; not allowed inside parallel_for()
+void set_worker_count(unsigned int worker_count);
@@ -9,7 +9,7 @@
 // Boar creation
 Entity createBoar(vec2 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Setting intial	 motion values
 	Motion& motion = registry.motions.emplace(entity);
@@ -20,11 +20,12 @@ Entity createBoar(vec2 pos)
 	motion.solid = true;
 
 	Enemy& enemy = registry.enemies.emplace(entity);
+	EnemyInfo& info = registry.enemies.cold(entity);
 	enemy.damage = BOAR_DAMAGE;
-	enemy.points = 2;
-	enemy.maxHealth = BOAR_HEALTH;
-	enemy.health = enemy.maxHealth;
-	enemy.type = "BOAR";
+	info.points = 2;
+	info.maxHealth = BOAR_HEALTH;
+	enemy.health = info.maxHealth;
+	info.type = ENEMY_TYPE::BOAR;
 	motion.speed = BOAR_SPEED;
 
 	registry.boars.emplace(entity);
@@ -52,7 +53,7 @@ Entity createBoar(vec2 pos)
 // Barbarian creation
 Entity createBarbarian(vec2 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Setting intial motion values
 	Motion& motion = registry.motions.emplace(entity);
@@ -63,11 +64,12 @@ Entity createBarbarian(vec2 pos)
 	motion.solid = true;
 	
 	Enemy& enemy = registry.enemies.emplace(entity);
+	EnemyInfo& info = registry.enemies.cold(entity);
 	enemy.damage = BARBARIAN_DAMAGE;
 	enemy.cooldown = 1000;
-	enemy.maxHealth = BARBARIAN_HEALTH;
-	enemy.health = enemy.maxHealth;
-	enemy.type = "BARBARIAN";
+	info.maxHealth = BARBARIAN_HEALTH;
+	enemy.health = info.maxHealth;
+	info.type = ENEMY_TYPE::BARBARIAN;
 	motion.speed = BARBARIAN_SPEED;
 
 	registry.barbarians.emplace(entity);
@@ -88,7 +90,7 @@ Entity createBarbarian(vec2 pos)
 // Archer creation
 Entity createArcher(vec2 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Setting intial motion values
 	Motion& motion = registry.motions.emplace(entity);
@@ -99,11 +101,12 @@ Entity createArcher(vec2 pos)
 	motion.solid = true;
 
 	Enemy& enemy = registry.enemies.emplace(entity);
+	EnemyInfo& info = registry.enemies.cold(entity);
 	enemy.damage = ARCHER_DAMAGE;
-	enemy.maxHealth = ARCHER_HEALTH;
-	enemy.health = enemy.maxHealth;
-	enemy.points = 3;
-	enemy.type = "ARCHER";
+	info.maxHealth = ARCHER_HEALTH;
+	enemy.health = info.maxHealth;
+	info.points = 3;
+	info.type = ENEMY_TYPE::ARCHER;
 	motion.speed = ARCHER_SPEED;
 
 	registry.archers.emplace(entity);
@@ -140,7 +143,7 @@ Entity createBirdFlock(vec2 pos)
 }
 
 Entity createBird(vec2 birdPosition) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Motion& motion = registry.motions.emplace(entity);
 	motion.position = vec3(birdPosition, TREE_BB_HEIGHT - BIRD_BB_WIDTH);
@@ -150,11 +153,12 @@ Entity createBird(vec2 birdPosition) {
 	motion.solid = true;
 
 	Enemy& enemy = registry.enemies.emplace(entity);
+	EnemyInfo& info = registry.enemies.cold(entity);
 	enemy.damage = BIRD_DAMAGE;
 	enemy.cooldown = 2000.f;
-	enemy.maxHealth = BIRD_HEALTH;
-	enemy.health = enemy.maxHealth;
-	enemy.type = "BIRD";
+	info.maxHealth = BIRD_HEALTH;
+	enemy.health = info.maxHealth;
+	info.type = ENEMY_TYPE::BIRD;
 	motion.speed = BIRD_SPEED;
 
 	registry.birds.emplace(entity);
@@ -171,7 +175,7 @@ Entity createBird(vec2 birdPosition) {
 }
 // Wizard creation
 Entity createWizard(vec2 pos) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Setting intial motion values
 	Motion& motion = registry.motions.emplace(entity);
@@ -182,12 +186,13 @@ Entity createWizard(vec2 pos) {
 	motion.solid = true;
 
 	Enemy& enemy = registry.enemies.emplace(entity);
+	EnemyInfo& info = registry.enemies.cold(entity);
 	enemy.damage = WIZARD_DAMAGE;
-	enemy.type = "WIZARD";
+	info.type = ENEMY_TYPE::WIZARD;
 	enemy.cooldown = 8000.f; // 8s
-	enemy.maxHealth = WIZARD_HEALTH;
-	enemy.health = enemy.maxHealth;
-	enemy.points = 5;
+	info.maxHealth = WIZARD_HEALTH;
+	enemy.health = info.maxHealth;
+	info.points = 5;
 	motion.speed = WIZARD_SPEED;
 
 	registry.wizards.emplace(entity);
@@ -204,9 +209,18 @@ Entity createWizard(vec2 pos) {
 	return entity;
 }
 
+// Turns a newly created troll at pos towards the player
+static void facePlayer(Motion& motion, vec2 pos)
+{
+	if (registry.players.entities.size() > 0) {
+		vec2 playerPosition = vec2(registry.motions.get(registry.players.entities.at(0)).position);
+		motion.facing = normalize(playerPosition - pos);
+	}
+}
+
 Entity createTroll(vec2 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Setting intial motion values
 	Motion& motion = registry.motions.emplace(entity);
@@ -215,19 +229,17 @@ Entity createTroll(vec2 pos)
 	motion.scale = { TROLL_BB_WIDTH, TROLL_BB_HEIGHT };
 	motion.hitbox = { TROLL_BB_WIDTH * 0.9, TROLL_BB_WIDTH * 0.9, TROLL_BB_HEIGHT * 0.9 / zConversionFactor };
 	motion.solid = true;
-	if (registry.players.entities.size() > 0) {
-		vec2 playerPosition = vec2(registry.motions.get(registry.players.entities.at(0)).position);
-		motion.facing = normalize(playerPosition - pos);
-	}
+	facePlayer(motion, pos);
 
 	Enemy& enemy = registry.enemies.emplace(entity);
+	EnemyInfo& info = registry.enemies.cold(entity);
 	enemy.damage = TROLL_DAMAGE;
-	enemy.points = 10;
-	enemy.type = "TROLL";
+	info.points = 10;
+	info.type = ENEMY_TYPE::TROLL;
 	enemy.cooldown = 0;
 	motion.speed = TROLL_SPEED;
-	enemy.maxHealth = TROLL_HEALTH;
-	enemy.health = enemy.maxHealth;
+	info.maxHealth = TROLL_HEALTH;
+	enemy.health = info.maxHealth;
 
 	registry.trolls.emplace(entity);
 
@@ -248,7 +260,7 @@ Entity createTroll(vec2 pos)
 // Bomber creation
 Entity createBomber(vec2 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Setting intial motion values
 	Motion& motion = registry.motions.emplace(entity);
@@ -259,10 +271,11 @@ Entity createBomber(vec2 pos)
 	motion.solid = true;
 
 	Enemy& enemy = registry.enemies.emplace(entity);
+	EnemyInfo& info = registry.enemies.cold(entity);
 	enemy.damage = BOMBER_DAMAGE;
-	enemy.type = "BOMBER";
-	enemy.maxHealth = BOMBER_HEALTH;
-	enemy.health = enemy.maxHealth;
+	info.type = ENEMY_TYPE::BOMBER;
+	info.maxHealth = BOMBER_HEALTH;
+	enemy.health = info.maxHealth;
 	motion.speed = BOMBER_SPEED;
 
 	registry.bombers.emplace(entity);
@@ -279,19 +292,44 @@ Entity createBomber(vec2 pos)
 	return entity;
 };
 
+// Builds the prefab of a spawnable by creating one at the origin, capturing it and destroying it again
+Prefab createPrefab(Entity (*create)(vec2))
+{
+	Entity entity = create(vec2(0, 0));
+	Prefab prefab(entity);
+	registry.remove_all_components_of(entity);
+	return prefab;
+}
+
+// Creates one instance of prefab at each position, all components go in with one batch per container
+void spawn_n(const Prefab& prefab, const std::vector<vec2>& positions)
+{
+	size_t n = positions.size();
+	std::vector<Entity> spawned;
+	prefab.instantiate(n, spawned);
+	for (size_t i = 0; i < n; i++) {
+		Entity entity = spawned[i];
+		// prefabs are built at the origin and the map is flat (see getElevation), so the spawn position is a plain offset
+		Motion& motion = registry.motions.get(entity);
+		motion.position += vec3(positions[i], 0);
+		if (registry.trolls.has(entity))
+			facePlayer(motion, positions[i]);
+	}
+}
+
 // Collectible trap creation
 Entity createCollectibleTrap(vec2 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 	CollectibleTrap& collectibleTrap = registry.collectibleTraps.emplace(entity);
 	int random = rand() % 2;
 	Motion& motion = registry.motions.emplace(entity);
 
 	if (random >= 0.8) {
-		collectibleTrap.type = "phantom_trap";
+		collectibleTrap.type = TRAP_TYPE::PHANTOM;
 		initPhantomTrapAnimationController(entity);
 		Collectible& collectible = registry.collectibles.emplace(entity);
-		collectible.type = "PHANTOM_TRAP";
+		collectible.type = COLLECTIBLE_TYPE::PHANTOM_TRAP;
 		
 		motion.position = vec3(pos, getElevation(pos) + PHANTOM_TRAP_COLLECTABLE_BB_HEIGHT / 2);
 		motion.angle = 0.f;
@@ -301,7 +339,7 @@ Entity createCollectibleTrap(vec2 pos)
 	else {
 		initTrapBottleAnimationController(entity);
 		Collectible& collectible = registry.collectibles.emplace(entity);
-		collectible.type = "TRAP";
+		collectible.type = COLLECTIBLE_TYPE::TRAP;
 
 		motion.position = vec3(pos, getElevation(pos) + TRAP_COLLECTABLE_BB_HEIGHT / 2);
 		motion.angle = 0.f;
@@ -316,7 +354,7 @@ Entity createCollectibleTrap(vec2 pos)
 
 Entity createCollectible(vec2 pos, TEXTURE_ASSET_ID assetID)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Motion& motion = registry.motions.emplace(entity);
 	motion.angle = 0.f;
@@ -336,14 +374,14 @@ Entity createCollectible(vec2 pos, TEXTURE_ASSET_ID assetID)
 			motion.scale = { BOW_BB_WIDTH, BOW_BB_HEIGHT };
 			registry.bows.emplace(entity);
 			collectible.duration = 10000;
-			collectible.type = "BOW";
+			collectible.type = COLLECTIBLE_TYPE::BOW;
 			initBowAnimationController(entity);
 			break;
 		case TEXTURE_ASSET_ID::BOMB:
 			motion.scale = { BOMB_BB_WIDTH, BOMB_BB_HEIGHT };
 			registry.collectibleBombs.emplace(entity);
 			collectible.duration = 10000;
-			collectible.type = "BOMB";
+			collectible.type = COLLECTIBLE_TYPE::BOMB;
 			initBombAnimationController(entity);
 			break;
 		default:
@@ -361,7 +399,7 @@ Entity createCollectible(vec2 pos, TEXTURE_ASSET_ID assetID)
 // Heart creation
 Entity createHeart(vec2 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 	registry.hearts.emplace(entity);
 
 	// Setting intial motion values
@@ -372,7 +410,7 @@ Entity createHeart(vec2 pos)
 	fixed.hitbox = { HEART_BB_WIDTH, HEART_BB_WIDTH, HEART_BB_HEIGHT / zConversionFactor };
 
 	Collectible& collectible = registry.collectibles.emplace(entity);
-	collectible.type = "HEART";
+	collectible.type = COLLECTIBLE_TYPE::HEART;
 
 	initHeartAnimationController(entity);
 
@@ -383,7 +421,7 @@ Entity createHeart(vec2 pos)
 
 Entity createCollected(TEXTURE_ASSET_ID assetID)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 	vec2 scale;
 
 	Motion& motion = registry.motions.emplace(entity);
@@ -406,6 +444,10 @@ Entity createCollected(TEXTURE_ASSET_ID assetID)
 	}
 	motion.scale = scale;
 
+	// shown next to the player's health bar
+	Entity player = registry.players.entities[0];
+	registry.attach(entity, player, { registry.healthBars.get(player).width / 2 + 15, 0, 30 }, true);
+
 	registry.collected.emplace(entity);
 	registry.midgrounds.emplace(entity);
 
@@ -423,7 +465,7 @@ Entity createCollected(TEXTURE_ASSET_ID assetID)
 // Damage trap creation
 Entity createDamageTrap(vec2 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Setting intial motion values
 	Motion& motion = registry.motions.emplace(entity);
@@ -449,7 +491,7 @@ Entity createDamageTrap(vec2 pos)
 };
 
 Entity createPhantomTrap(vec2 pos) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Setting intial motion values
 	Motion& motion = registry.motions.emplace(entity);
@@ -480,7 +522,7 @@ Entity createPhantomTrap(vec2 pos) {
 // Create Player Jeff
 Entity createJeff(vec2 position)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Initialize the motion
 	auto& motion = registry.motions.emplace(entity);
@@ -538,7 +580,7 @@ Entity createJeff(vec2 position)
 
 Entity createTree(RenderSystem* renderer, vec2 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	// Store a reference to the potentially re-used mesh object
 	Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::TREE);
@@ -581,7 +623,7 @@ Entity createTree(RenderSystem* renderer, vec2 pos)
 
 Entity createArrow(vec3 pos, vec3 velocity, int damage)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Motion& motion = registry.motions.emplace(entity);
 	motion.position = pos;
@@ -606,7 +648,7 @@ Entity createArrow(vec3 pos, vec3 velocity, int damage)
 }
 
 Entity createFireball(vec3 pos, vec2 direction) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Motion& motion = registry.motions.emplace(entity);
 	motion.position = pos;
@@ -616,7 +658,7 @@ Entity createFireball(vec3 pos, vec2 direction) {
 	motion.hitbox = { FIREBALL_HITBOX_WIDTH, FIREBALL_HITBOX_WIDTH, FIREBALL_HITBOX_WIDTH };
 
 	Damaging& damaging = registry.damagings.emplace(entity);
-	damaging.type = "fireball";
+	damaging.type = DAMAGING_TYPE::FIREBALL;
 	damaging.damage = 30;
 	registry.midgrounds.emplace(entity);
 
@@ -635,7 +677,7 @@ Entity createFireball(vec3 pos, vec2 direction) {
 
 
 Entity createEquipped(TEXTURE_ASSET_ID assetId) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 	vec2 scale;
 
 	switch (assetId) {
@@ -668,6 +710,8 @@ Entity createEquipped(TEXTURE_ASSET_ID assetId) {
 
 	Motion& motion = registry.motions.emplace(entity);
 	motion.scale = scale;
+	// held by the player, WorldSystem::updateEquippedAim() points the offset at the mouse
+	registry.attach(entity, registry.players.entities[0], { 0, 0, 0 });
 
 	registry.midgrounds.emplace(entity);
 
@@ -675,7 +719,7 @@ Entity createEquipped(TEXTURE_ASSET_ID assetId) {
 }
 
 Entity createLightning(vec2 pos) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Motion& motion = registry.motions.emplace(entity);
 	
@@ -685,7 +729,7 @@ Entity createLightning(vec2 pos) {
 	motion.position = vec3(pos, motion.hitbox.z / 2);
 
 	Damaging& damaging = registry.damagings.emplace(entity);
-	damaging.type = "lightning";
+	damaging.type = DAMAGING_TYPE::LIGHTNING;
 	damaging.damage = 20;
 	registry.midgrounds.emplace(entity);
 
@@ -706,16 +750,15 @@ Entity createLightning(vec2 pos) {
 }
 
 void createStaminaBar(Entity characterEntity) {
-	auto meshE = Entity();
+	auto meshE = Entity::create();
 
 	const float width = 60.0f;
 	const float height = 10.0f;
 
-	Motion& characterMotion = registry.motions.get(characterEntity);
-
 	Motion& motion = registry.motions.emplace(meshE);
-	// position does not need to be initialized as it will always be set to match the associated entity
+	// position does not need to be initialized, the bar is attached above the character
 	motion.angle = 0.f;
+	registry.attach(meshE, characterEntity, { -width / 2, 0, 25 }, true);
 	motion.scale = { width, height };
 
 	vec4 blue = vec4(0.0f, 0.0f, 1.0f, 1.0f);
@@ -731,10 +774,10 @@ void createStaminaBar(Entity characterEntity) {
 	registry.midgrounds.emplace(meshE);
 
 	// HP bar frame
-	auto frameE = Entity();
+	auto frameE = Entity::create();
 	Motion& frameM = registry.motions.emplace(frameE);
-	frameM.position = motion.position;
 	frameM.scale = { width, height };
+	registry.attach(frameE, characterEntity, { -width / 2, 0, 25 }, true);
 	registry.colours.insert(frameE, blue);
 	registry.renderRequests.insert(
 		frameE,
@@ -752,7 +795,7 @@ void createStaminaBar(Entity characterEntity) {
 }
 
 void createPlayerUIStaminaBar(vec2 windowSize) {
-	auto meshE = Entity();
+	auto meshE = Entity::create();
 	const float width = 150.0f;
 	const float height = 20.0f;
 
@@ -774,7 +817,7 @@ void createPlayerUIStaminaBar(vec2 windowSize) {
 		});
 
 	// Bar frame
-	auto frameE = Entity();
+	auto frameE = Entity::create();
 	Foreground& frameFg = registry.foregrounds.emplace(frameE);
 	frameFg.position = position;
 	frameFg.scale = { width, height };
@@ -788,7 +831,7 @@ void createPlayerUIStaminaBar(vec2 windowSize) {
 			PRIMITIVE_TYPE::LINES,
 		});
 
-	auto textE = Entity();
+	auto textE = Entity::create();
 	registry.texts.emplace(textE);
 	Foreground& textFg = registry.foregrounds.emplace(textE);
 	textFg.scale = {0.8f, 0.8f};
@@ -804,10 +847,11 @@ void createPlayerUIStaminaBar(vec2 windowSize) {
 	registry.playerResourceUI.staminaMeshEntity = meshE;
 	registry.playerResourceUI.staminaFrameEntity = frameE;
 	registry.playerResourceUI.staminaTextEntity = textE;
+	registry.playerResourceUI.shownStamina = -1;
 }
 
 void createPlayerUIHealthBar(vec2 windowSize) {
-	auto meshE = Entity();
+	auto meshE = Entity::create();
 	vec2 maxSize = registry.playerResourceUI.hpMaxSize;
 
 	vec2 position = {210.0f, windowSize.y - 50.0f};
@@ -829,7 +873,7 @@ void createPlayerUIHealthBar(vec2 windowSize) {
 		});
 
 	// Bar frame
-	auto frameE = Entity();
+	auto frameE = Entity::create();
 	Foreground& frameFg = registry.foregrounds.emplace(frameE);
 	frameFg.position = position;
 	frameFg.scale = maxSize;
@@ -843,7 +887,7 @@ void createPlayerUIHealthBar(vec2 windowSize) {
 			PRIMITIVE_TYPE::LINES,
 		});
 
-	auto textE = Entity();
+	auto textE = Entity::create();
 	registry.texts.emplace(textE);
 	Foreground& textFg = registry.foregrounds.emplace(textE);
 	textFg.scale = {0.8f, 0.8f};
@@ -858,19 +902,25 @@ void createPlayerUIHealthBar(vec2 windowSize) {
 	registry.playerResourceUI.hpMeshEntity = meshE;
 	registry.playerResourceUI.hpFrameEntity = frameE;
 	registry.playerResourceUI.hpTextEntity = textE;
+	registry.playerResourceUI.shownHealth = -1;
 }
 
 void createHealthBar(Entity characterEntity) {
-	auto meshEntity = Entity();
+	auto meshEntity = Entity::create();
 
 	const float width = 60.0f;
 	const float height = 10.0f;
 
-	Motion& characterMotion = registry.motions.get(characterEntity);
+	// place above the character, the player's also clears its stamina bar
+	float topOffset = 25;
+	if (registry.players.has(characterEntity)) {
+		topOffset += height + 5;
+	}
 
 	Motion& motion = registry.motions.emplace(meshEntity);
-	// position does not need to be initialized as it will always be set to match the associated entity
+	// position does not need to be initialized, the bar is attached above the character
 	motion.angle = 0.f;
+	registry.attach(meshEntity, characterEntity, { -width / 2, 0, topOffset }, true);
 	motion.scale = { width, height };
 
 	vec4 color = vec4(1, 0, 0, 0.4);
@@ -886,10 +936,10 @@ void createHealthBar(Entity characterEntity) {
 	registry.midgrounds.emplace(meshEntity);
 
 	// HP bar frame
-	auto frameEntity = Entity();
+	auto frameEntity = Entity::create();
 	Motion& frameM = registry.motions.emplace(frameEntity);
-	frameM.position = motion.position;
 	frameM.scale = { width, height };
+	registry.attach(frameEntity, characterEntity, { -width / 2, 0, topOffset }, true);
 	registry.colours.insert(frameEntity, color);
 	registry.renderRequests.insert(
 		frameEntity,
@@ -907,7 +957,7 @@ void createHealthBar(Entity characterEntity) {
 }
 
 Entity createTargetArea(vec3 position) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	float radius = 200.f;
 	Motion& motion = registry.motions.emplace(entity);
@@ -935,7 +985,7 @@ Entity createTargetArea(vec3 position) {
 }
 
 Entity createTutorialTarget(vec3 position) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Motion& motion = registry.motions.emplace(entity);
 	motion.position = position;
@@ -961,7 +1011,7 @@ Entity createTutorialTarget(vec3 position) {
 }
 
 Entity createPauseHelpText(vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Text& text = registry.texts.emplace(entity);
 	text.value = "PAUSE/PLAY(P)    HELP (H)";
@@ -981,7 +1031,7 @@ Entity createPauseHelpText(vec2 windowSize) {
 }
 
 Entity createFPSText(vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Text& text = registry.texts.emplace(entity);
 	text.value = "00 fps";
@@ -1002,7 +1052,7 @@ Entity createFPSText(vec2 windowSize) {
 }
 
 Entity createTitleScreenBackground(vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	registry.renderRequests.insert(
 		entity,
@@ -1020,7 +1070,7 @@ Entity createTitleScreenBackground(vec2 windowSize) {
 }
 
 Entity createTitleScreenTitle(vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	registry.renderRequests.insert(
 		entity,
@@ -1039,7 +1089,7 @@ Entity createTitleScreenTitle(vec2 windowSize) {
 
 
 Entity createTitleScreenText(vec2 windowSize, std::string value, float fontSize, vec2 position) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Text& text = registry.texts.emplace(entity);
 	text.value = value;
@@ -1059,7 +1109,7 @@ Entity createTitleScreenText(vec2 windowSize, std::string value, float fontSize,
 }
 
 Entity createGameTimerText(vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Text& text = registry.texts.emplace(entity);
 	text.value = "00:00:00";
@@ -1078,10 +1128,16 @@ Entity createGameTimerText(vec2 windowSize) {
 	return entity;
 }
 
+void setTextValue(Entity entity, const std::string& value) {
+	if (registry.texts.get(entity).value != value) {
+		registry.texts.patch(entity, [&value](Text& text) { text.value = value; });
+	}
+}
+
 Entity createItemCountText(vec2 windowSize, TEXTURE_ASSET_ID assetID) {
-	auto textKeybindE = Entity();
-	auto textCountE = Entity();
-	auto iconE = Entity();
+	auto textKeybindE = Entity::create();
+	auto textCountE = Entity::create();
+	auto iconE = Entity::create();
 	vec2 startPos = {420.0f, windowSize.y - 30.0f};
 	vec2 iconScale;
 	vec2 position;
@@ -1161,7 +1217,7 @@ Entity createItemCountText(vec2 windowSize, TEXTURE_ASSET_ID assetID) {
 }
 
 Entity createMapTile(vec2 position, vec2 size, float height) {
-    auto entity = Entity();
+    auto entity = Entity::create();
 	registry.mapTiles.emplace(entity);
 	Motion& motion = registry.motions.emplace(entity);
 	motion.position = vec3(position, height);
@@ -1201,7 +1257,7 @@ void createObstacles() {
 }
 
 Entity createObstacle(vec2 position, vec2 size, TEXTURE_ASSET_ID assetId) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.obstacles.emplace(entity);
 
     Motion& motion = registry.motions.emplace(entity);
@@ -1224,7 +1280,7 @@ Entity createObstacle(vec2 position, vec2 size, TEXTURE_ASSET_ID assetId) {
 }
 
 Entity createNormalObstacle(vec2 position, vec2 size, TEXTURE_ASSET_ID assetId) {
-    auto entity = Entity();
+    auto entity = Entity::create();
     registry.obstacles.emplace(entity);
 
     Motion& motion = registry.motions.emplace(entity);
@@ -1250,7 +1306,7 @@ Entity createNormalObstacle(vec2 position, vec2 size, TEXTURE_ASSET_ID assetId)
 
 
 Entity createBottomCliff(vec2 position, vec2 size) {
-    auto entity = Entity();
+    auto entity = Entity::create();
 	Motion& motion = registry.motions.emplace(entity);
 	motion.position = vec3(position, size.y / 2);
 	motion.scale = vec2(size.x, size.y * yConversionFactor);
@@ -1271,7 +1327,7 @@ Entity createBottomCliff(vec2 position, vec2 size) {
 }
 
 Entity createSideCliff(vec2 position, vec2 size) {
-    auto entity = Entity();
+    auto entity = Entity::create();
 	registry.mapTiles.emplace(entity);
 	Motion& motion = registry.motions.emplace(entity);
 	motion.position = vec3(position, size.y / 2);
@@ -1292,7 +1348,7 @@ Entity createSideCliff(vec2 position, vec2 size) {
     return entity;
 }
 Entity createTopCliff(vec2 position, vec2 size) {
-    auto entity = Entity();
+    auto entity = Entity::create();
 	Motion& motion = registry.motions.emplace(entity);
 	motion.position = vec3(position, size.y / 2);
 	motion.scale = vec2(size.x, size.y * yConversionFactor);
@@ -1348,7 +1404,7 @@ void createMapTiles() {
 }
 
 void createGameOverText(vec2 windowSize) {
-	auto backdrop = Entity();
+	auto backdrop = Entity::create();
 	Foreground& backdropFg = registry.foregrounds.emplace(backdrop);
 	backdropFg.position = {0.0f, 0.0f};
 	backdropFg.scale = {windowSize.x, windowSize.y};
@@ -1366,7 +1422,7 @@ void createGameOverText(vec2 windowSize) {
 	GameTimer& gameTimer = registry.gameTimer;
 	GameScore& gameScore = registry.gameScore;
 
-	auto entity1 = Entity();
+	auto entity1 = Entity::create();
 	Text& text1 = registry.texts.emplace(entity1);
 	Foreground& text1Fg = registry.foregrounds.emplace(entity1);
 	text1.value = "GAME OVER";
@@ -1374,7 +1430,7 @@ void createGameOverText(vec2 windowSize) {
 	text1Fg.scale = {4.0f, 4.0f};
 	registry.colours.insert(entity1, {0.85f, 0.0f, 0.0f, 1.0f});
 
-	auto entity2 = Entity();
+	auto entity2 = Entity::create();
 	Text& text2 = registry.texts.emplace(entity2);
 	text2.lineSpacing = 1.5f;
 	text2.alignment = TEXT_ALIGNMENT::CENTER;
@@ -1404,7 +1460,7 @@ void createGameOverText(vec2 windowSize) {
 	oss << gameScore.highScoreSeconds << "s";
 	text2.value += oss.str();
 
-	auto entity3 = Entity();
+	auto entity3 = Entity::create();
 	Text& text3 = registry.texts.emplace(entity3);
 	text3.value = "Press ENTER to play again";
 	Foreground& text3Fg = registry.foregrounds.emplace(entity3);
@@ -1428,7 +1484,7 @@ void createGameOverText(vec2 windowSize) {
 
 Entity createProjectile(vec3 pos, vec3 velocity, PROJECTILE_TYPE type)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Motion& motion = registry.motions.emplace(entity);
 	motion.position = pos;
@@ -1459,7 +1515,7 @@ Entity createProjectile(vec3 pos, vec3 velocity, PROJECTILE_TYPE type)
 }
 
 Entity createMousePointer(vec2 mousePos) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Foreground& fg = registry.foregrounds.emplace(entity);
 	fg.scale = { 40.0f, 40.0f};
@@ -1477,7 +1533,7 @@ Entity createMousePointer(vec2 mousePos) {
 }
 
 void createGameSaveText(vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	Text& text = registry.texts.emplace(entity);
 	text.value = "Game Saved!";
@@ -1514,7 +1570,7 @@ void createTrees(RenderSystem* renderer) {
 }
 
 Entity createPointsEarnedText(std::string textValue, Entity anchoredWorldEntity, vec4 color) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 	Motion& anchoredMotion = registry.motions.get(anchoredWorldEntity);
 	Text& text = registry.texts.emplace(entity);
 	text.value = textValue;
@@ -1546,7 +1602,7 @@ Entity createPointsEarnedText(std::string textValue, Entity anchoredWorldEntity,
 }
 
 Entity createComboText(int comboValue, vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
 	Text& text = registry.texts.emplace(entity);
 	text.value = "COMBO *" + std::to_string(comboValue);
 	text.alignment = TEXT_ALIGNMENT::CENTER;
@@ -1576,7 +1632,8 @@ Entity createComboText(int comboValue, vec2 windowSize) {
 }
 
 Entity createScoreText(vec2 windowSize) {
-	auto entity = Entity();
+	auto entity = Entity::create();
+	registry.gameScore.shownScore = -1;
 
 	registry.texts.emplace(entity);
 	Foreground& fg = registry.foregrounds.emplace(entity);
@@ -1596,7 +1653,7 @@ Entity createScoreText(vec2 windowSize) {
 
 void createExplosion(vec3 pos)
 {
-	auto entity = Entity();
+	auto entity = Entity::create();
 
 	registry.explosions.emplace(entity);
 	Damaging& dmg = registry.damagings.emplace(entity);
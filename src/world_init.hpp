@@ -3,6 +3,7 @@
 #include "common.hpp"
 #include "tiny_ecs.hpp"
 #include "render_system.hpp"
+#include "prefab.hpp"
 
 // hardcoded dimensions of player and enemies (boar, babarian, and archer)
 // BB = Bounding Box
@@ -126,6 +127,11 @@ Entity createBomber(vec2 pos);
 // The collectible trap
 Entity createCollectibleTrap(vec2 pos);
 
+// Prefabs of the spawnables: build one from a create function, then stamp out copies at the given positions
+// Projectiles are not prefabs: they are created one per shot with per-shot arguments, so there is no batch to save on
+Prefab createPrefab(Entity (*create)(vec2));
+void spawn_n(const Prefab& prefab, const std::vector<vec2>& positions);
+
 // The collectible heart
 Entity createHeart(vec2 pos);
 
@@ -163,6 +169,8 @@ Entity createPointsEarnedText(std::string text, Entity anchoredWorldEntity, vec4
 Entity createComboText(int comboValue, vec2 windowSize);
 Entity createScoreText(vec2 windowSize);
 Entity createItemCountText(vec2 windowSize, TEXTURE_ASSET_ID assetID);
+// Sets the value of a text, only recording a change (and a re-layout) if it differs
+void setTextValue(Entity entity, const std::string& value);
 
 Entity createMousePointer(vec2 mousePos);
 Entity createProjectile(vec3 pos, vec3 velocity, PROJECTILE_TYPE type);
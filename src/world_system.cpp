@@ -86,8 +86,8 @@ void WorldSystem::restart_game()
 
     tutorialDelayTimer = 0.0f;
     hasSwitchedToTutorial = false;
-    encounteredEnemies.clear();
-    encounteredCollectibles.clear();
+    encounteredEnemies.reset();
+    encounteredCollectibles.reset();
 }
 
 void WorldSystem::load_game() {
@@ -117,8 +117,7 @@ void WorldSystem::updateGameTimer(float elapsed_ms) {
        << std::setw(2) << std::setfill('0') << gameTimer.minutes << ":"
        << std::setw(2) << std::setfill('0') << gameTimer.seconds;
 
-    Text& text = registry.texts.get(gameTimer.textEntity);
-    text.value = ss.str();
+    setTextValue(gameTimer.textEntity, ss.str());
 }
 
 void WorldSystem::handleSurvivalBonusPoints(float elapsed_ms) {
@@ -160,8 +159,7 @@ void WorldSystem::trackFPS(float elapsed_ms) {
     fpsTracker.update(elapsed_ms);
 
     if(fpsTracker.elapsedTime == 0) {
-        Text& text = registry.texts.get(fpsTracker.textEntity);
-        text.value = std::to_string(fpsTracker.fps) + " fps";
+        setTextValue(fpsTracker.textEntity, std::to_string(fpsTracker.fps) + " fps");
     }
 }
 
@@ -169,10 +167,9 @@ void WorldSystem::updateInventoryItemText() {
     Inventory& inventory = registry.inventory;
     for (auto& item : inventory.itemCountTextEntities) {
         if(registry.texts.has(item.second)) {
-            Text& text = registry.texts.get(item.second);
             std::stringstream ss;
             ss << std::setw(2) << std::setfill('0') << inventory.itemCounts[item.first];
-            text.value = "*" + ss.str();
+            setTextValue(item.second, "*" + ss.str());
 
             if(inventory.itemCounts[item.first] == 0) {
                 registry.colours.get(item.second) = {0.8f, 0.8f, 0.0f, 1.0f};
@@ -189,15 +186,13 @@ void WorldSystem::updateTrapsCounterText() {
     int phantomTrapCount = trapsCounter.trapsMap["phantom_trap"].first;
     Entity& phantomTrapTextEntity = trapsCounter.trapsMap["phantom_trap"].second;
 
-    Text& damageTrapText = registry.texts.get(damageTrapTextEntity);
     std::stringstream ss;
     ss << std::setw(2) << std::setfill('0') << damageTrapCount;
-    damageTrapText.value = "*" + ss.str();
+    setTextValue(damageTrapTextEntity, "*" + ss.str());
 
-	Text& phantomTrapText = registry.texts.get(phantomTrapTextEntity);
 	std::stringstream ss2;
 	ss2 << std::setw(2) << std::setfill('0') << phantomTrapCount;
-	phantomTrapText.value = "*" + ss2.str();
+	setTextValue(phantomTrapTextEntity, "*" + ss2.str());
 
     // Damage Trap
     if(damageTrapCount == 0) {
@@ -245,32 +240,32 @@ void WorldSystem::updateEnemyTutorial() {
         float distance = glm::distance(playerPosition, enemyPosition);
 
          if (distance <= 600.0f) {
-            std::string enemyType = registry.enemies.get(enemy).type; 
-            if (encounteredEnemies.find(enemyType) == encounteredEnemies.end()) {
+            ENEMY_TYPE enemyType = registry.enemies.cold(enemy).type;
+            if (!encounteredEnemies.test((int)enemyType)) {
                 createTutorialTarget(motion.position);
-                if (enemyType == "BOAR") {
+                if (enemyType == ENEMY_TYPE::BOAR) {
                     gameStateController.setGameState(GAME_STATE::BOAR_TUTORIAL);
                 }
-                if (enemyType == "BIRD") {
+                if (enemyType == ENEMY_TYPE::BIRD) {
                     gameStateController.setGameState(GAME_STATE::BIRD_TUTORIAL);
                 }
-                if (enemyType == "TROLL") {
+                if (enemyType == ENEMY_TYPE::TROLL) {
                     gameStateController.setGameState(GAME_STATE::TROLL_TUTORIAL);
                 }
-                if (enemyType == "WIZARD") {
+                if (enemyType == ENEMY_TYPE::WIZARD) {
                     gameStateController.setGameState(GAME_STATE::WIZARD_TUTORIAL);
                 }
-                if (enemyType == "ARCHER") {
+                if (enemyType == ENEMY_TYPE::ARCHER) {
                     gameStateController.setGameState(GAME_STATE::ARCHER_TUTORIAL);
                 }
-                if (enemyType == "BARBARIAN") {
+                if (enemyType == ENEMY_TYPE::BARBARIAN) {
                     gameStateController.setGameState(GAME_STATE::BARBARIAN_TUTORIAL);
                 }
-                if (enemyType == "BOMBER") {
+                if (enemyType == ENEMY_TYPE::BOMBER) {
                     gameStateController.setGameState(GAME_STATE::BOMBER_TUTORIAL);
                 }
                 
-                encounteredEnemies.insert(enemyType);
+                encounteredEnemies.set((int)enemyType);
                 break; 
             }
         }
@@ -286,37 +281,38 @@ void WorldSystem::updateCollectibleTutorial() {
         vec2 collectiblePosition = { motion.position.x, motion.position.y };
         float distance = glm::distance(playerPosition, collectiblePosition);
         if (distance <= 200.0f) {
-            std::string collectibleType = registry.collectibles.get(collectible).type; 
-            if (encounteredCollectibles.find(collectibleType) == encounteredCollectibles.end()) {
+            COLLECTIBLE_TYPE collectibleType = registry.collectibles.get(collectible).type;
+            if (!encounteredCollectibles.test((int)collectibleType)) {
                 createTutorialTarget(motion.position);
-                if (collectibleType == "HEART") {
+                if (collectibleType == COLLECTIBLE_TYPE::HEART) {
                     gameStateController.setGameState(GAME_STATE::HEART_TUTORIAL);
                 }
-                if (collectibleType == "TRAP") {
+                if (collectibleType == COLLECTIBLE_TYPE::TRAP) {
                     gameStateController.setGameState(GAME_STATE::TRAP_TUTORIAL);
                 }
-                if (collectibleType == "PHANTOM_TRAP") {
+                if (collectibleType == COLLECTIBLE_TYPE::PHANTOM_TRAP) {
                     gameStateController.setGameState(GAME_STATE::PHANTOM_TRAP_TUTORIAL);
                 }
-                if (collectibleType == "BOW") {
+                if (collectibleType == COLLECTIBLE_TYPE::BOW) {
                     gameStateController.setGameState(GAME_STATE::BOW_TUTORIAL);
                 }
-                if (collectibleType == "BOMB") {
+                if (collectibleType == COLLECTIBLE_TYPE::BOMB) {
                     gameStateController.setGameState(GAME_STATE::BOMB_TUTORIAL);
                 }
-                encounteredCollectibles.insert(collectibleType);
+                encounteredCollectibles.set((int)collectibleType);
                 break; 
             }
         }
     }
 }
-void WorldSystem::updateEquippedPosition() {
+// Points the equipped item from the player towards the mouse, its position follows the player through its Attachment
+void WorldSystem::updateEquippedAim() {
 	Entity& playerE = registry.players.entities[0];
 	Motion& playerM = registry.motions.get(playerE);
 
-    if(registry.motions.has(registry.inventory.equippedEntity)) {
+    if(registry.attachments.has(registry.inventory.equippedEntity)) {
         Motion& equippedM = registry.motions.get(registry.inventory.equippedEntity);
-        equippedM.position = playerM.position;
+        Attachment& attachment = registry.attachments.get(registry.inventory.equippedEntity);
 
         double mousePosX, mousePosY;
         glfwGetCursorPos(window, &mousePosX, &mousePosY);
@@ -327,7 +323,7 @@ void WorldSystem::updateEquippedPosition() {
         vec3 direction = mouseWorldPos - playerM.position;
         vec3 normalizedDirection = normalize(direction);
 
-        equippedM.position = playerM.position + normalizedDirection * fixedDistance;
+        attachment.offset = normalizedDirection * fixedDistance;
 
         if(registry.inventory.equipped == INVENTORY_ITEM::BOW) {
             float angle = atan2(direction.y, direction.x);
@@ -359,7 +355,7 @@ bool WorldSystem::step(float elapsed_ms)
     updateScoreText();
     handleSurvivalBonusPoints(elapsed_ms);
     updateHomingProjectiles(elapsed_ms);
-    updateEquippedPosition();
+    updateEquippedAim();
     updatePointLightPositions(elapsed_ms);
 
     if (camera->isToggled()) {
@@ -406,17 +402,20 @@ void WorldSystem::handleEnemiesKilledInSpan(float elapsed_ms) {
 void WorldSystem::updateComboText() {
     EnemiesKilled& enemiesKilled = gameStateController.enemiesKilled;
     if(registry.texts.has(enemiesKilled.comboTextEntity) && enemiesKilled.killSpanCount > 1) {
-        Text& text = registry.texts.get(enemiesKilled.comboTextEntity);
         SlideUp& slideUp = registry.slideUps.get(enemiesKilled.comboTextEntity);
-        text.value = "COMBO *" + std::to_string(enemiesKilled.killSpanCount);
+        setTextValue(enemiesKilled.comboTextEntity, "COMBO *" + std::to_string(enemiesKilled.killSpanCount));
         slideUp.animationLength = 1500;
     }
 }
 
 void WorldSystem::updateScoreText() {
     GameScore& gameScore = registry.gameScore;
-    Text& text = registry.texts.get(gameScore.textEntity);
-    text.value = "Score: " + std::to_string(gameScore.score);
+    // only rebuild the string when the score changed
+    if (gameScore.score == gameScore.shownScore) {
+        return;
+    }
+    gameScore.shownScore = gameScore.score;
+    setTextValue(gameScore.textEntity, "Score: " + std::to_string(gameScore.score));
 }
 
 void WorldSystem::updatePointLightPositions(float elapsed_ms) {
@@ -522,7 +521,7 @@ void WorldSystem::handle_collisions()
             if (registry.players.has(entity_other) || registry.enemies.has(entity_other)) {
                 entity_damaging_collision(entity_other, entity, was_damaged);
             }
-            else if (damaging.type == "fireball" && registry.obstacles.has(entity_other)) {
+            else if (damaging.type == DAMAGING_TYPE::FIREBALL && registry.obstacles.has(entity_other)) {
 				// Collision between damaging and obstacle
                 damaging_obstacle_collision(entity);
             }
@@ -1150,6 +1149,14 @@ void WorldSystem::allStateControls(int key, int action, int mod)
             // toggle camera on/off for debugging/testing
             camera->toggle();
             break;
+        case GLFW_KEY_K:
+            // dump per-container memory use to the console
+            registry.print_memory_report();
+            break;
+        case GLFW_KEY_B:
+            // cycle the collision broadphase, printing the timing of the previous one
+            physics->setBroadphase((BROADPHASE)(((int)physics->getBroadphase() + 1) % broadphase_count));
+            break;
 #endif
         case GLFW_KEY_F:
             // toggle fps
@@ -1263,24 +1270,24 @@ void WorldSystem::update_player_facing(Player& player, Motion& motion)
 
 void WorldSystem::update_cooldown(float elapsed_ms) {
     // Tick type-specific cooldowns
-    for (auto& cooldownEntity : registry.cooldowns.entities) {
-        Cooldown& cooldown = registry.cooldowns.get(cooldownEntity);
+    // An expired cooldown is removed right away, so hits this frame are not blocked; the view makes that removal safe
+    registry.view<Cooldown>().each([&](Entity cooldownEntity, Cooldown& cooldown) {
         cooldown.remaining -= elapsed_ms;
 
         if (cooldown.remaining <= 0) {
             // remove lightning
-            if (registry.damagings.has(cooldownEntity) && registry.damagings.get(cooldownEntity).type == "lightning") {
-                registry.remove_all_components_of(cooldownEntity);
+            if (registry.damagings.has(cooldownEntity) && registry.damagings.get(cooldownEntity).type == DAMAGING_TYPE::LIGHTNING) {
+                registry.destroy_deferred(cooldownEntity);
             }
             // remove target area
             else if (registry.targetAreas.has(cooldownEntity)) {
-                registry.remove_all_components_of(cooldownEntity);
+                registry.destroy_deferred(cooldownEntity);
             }
             else {
                 registry.cooldowns.remove(cooldownEntity);
             }
         }
-    }
+    });
 
     // Tick general collision cooldowns
     auto it = collisionCooldowns.begin();
@@ -1295,14 +1302,13 @@ void WorldSystem::update_cooldown(float elapsed_ms) {
     }
 
     // Tick invulnerables
-    for (Entity entity : registry.invulnerables.entities) {
-        Invulnerable& invulnerable = registry.invulnerables.get(entity);
+    registry.view<Invulnerable>().each([&](Entity entity, Invulnerable& invulnerable) {
         invulnerable.timer -= elapsed_ms;
         if (invulnerable.timer < 0) {
             registry.invulnerables.remove(entity);
             registry.colours.remove(entity);
         }
-    }
+    });
 }
 
 void WorldSystem::handle_deaths(float elapsed_ms) {
@@ -1320,7 +1326,7 @@ void WorldSystem::handle_deaths(float elapsed_ms) {
                 Motion& motion = registry.motions.get(deathEntity);
                 createHeart({ motion.position.x, motion.position.y });
             }
-            registry.remove_all_components_of(deathEntity);
+            registry.destroy_deferred(deathEntity);
         }
     }
 }
@@ -1337,13 +1343,13 @@ void WorldSystem::entity_collectible_collision(Entity entity, Entity entity_othe
 
     if (registry.collectibleTraps.has(entity_other)) {
 		CollectibleTrap& collectibleTrap = registry.collectibleTraps.get(entity_other);
-        if (collectibleTrap.type == DAMAGE_TRAP) {
+        if (collectibleTrap.type == TRAP_TYPE::DAMAGE) {
             registry.inventory.itemCounts[INVENTORY_ITEM::TRAP]++;
 			trapsCounter.trapsMap[DAMAGE_TRAP].first = registry.inventory.itemCounts[INVENTORY_ITEM::TRAP];
 			createCollected(TEXTURE_ASSET_ID::TRAPCOLLECTABLE);
             equipItem(INVENTORY_ITEM::TRAP, true);
 		}
-        else if (collectibleTrap.type == PHANTOM_TRAP) {
+        else if (collectibleTrap.type == TRAP_TYPE::PHANTOM) {
             registry.inventory.itemCounts[INVENTORY_ITEM::PHANTOM_TRAP]++;
             trapsCounter.trapsMap[PHANTOM_TRAP].first = registry.inventory.itemCounts[INVENTORY_ITEM::PHANTOM_TRAP];
             createCollected(TEXTURE_ASSET_ID::PHANTOM_TRAP_BOTTLE_ONE);
@@ -1539,14 +1545,14 @@ void WorldSystem::checkAndHandleEnemyDeath(Entity enemy) {
             animationController.changeState(enemy, AnimationState::Dead);
         }
 
-        registry.gameScore.score += enemyData.points;
+        int points = registry.enemies.cold(enemy).points;
+        registry.gameScore.score += points;
         gameStateController.enemiesKilled.updateKillSpanCount();
-        createPointsEarnedText("+" + std::to_string(enemyData.points), enemy, {1.0f, 1.0f, 1.0f, 1.0f});
+        createPointsEarnedText("+" + std::to_string(points), enemy, {1.0f, 1.0f, 1.0f, 1.0f});
         updateComboText();
 
-        HealthBar& hpbar = registry.healthBars.get(enemy);
-        registry.remove_all_components_of(hpbar.meshEntity);
-        registry.remove_all_components_of(hpbar.frameEntity);
+        // the health bar is attached to the enemy
+        registry.destroy_children(enemy);
         registry.healthBars.remove(enemy);
         registry.enemies.remove(enemy);
         registry.deathTimers.emplace(enemy);
@@ -1579,14 +1585,7 @@ void WorldSystem::setCollisionCooldown(Entity damager, Entity victim)
 }
 
 void WorldSystem::destroyDamagings() {
-    for (auto& damagingEntity : registry.damagings.entities) {
-        if(registry.bounceables.has(damagingEntity) || registry.explosions.has(damagingEntity)) {
-            continue;
-        }
-
-        Damaging& damaging = registry.damagings.get(damagingEntity);
-        Motion& motion = registry.motions.get(damagingEntity);
-
+    registry.view<Damaging, Motion>(exclude<Bounceable, Explosion>).each([&](Entity damagingEntity, Damaging& damaging, Motion& motion) {
         // half scale
 		float halfScaleX = abs(motion.scale.x) / 2;
 		float halfScaleY = abs(motion.scale.y) / 2;
@@ -1598,9 +1597,9 @@ void WorldSystem::destroyDamagings() {
 
 		// Destroy if it collides with the map bounds (fireball)
         if (collidesWithLeft || collidesWithRight || collidesWithTop || collidesWithBottom) {
-            registry.remove_all_components_of(damagingEntity);
+            registry.destroy_deferred(damagingEntity);
         }
-    }
+    });
 }
 
 void WorldSystem::checkAndHandlePlayerDeath(Entity& entity) {
@@ -1703,11 +1702,8 @@ void WorldSystem::on_window_focus(int focused) {
 }
 
 void WorldSystem::accelerateFireballs(float elapsed_ms) {
-    for (auto entity : registry.damagings.entities) {
-        Damaging& dmgEntity = registry.damagings.get(entity);
-        if (dmgEntity.type == "fireball") {
-            Motion& fireballMotion = registry.motions.get(entity);
-
+    registry.view<Damaging, Motion>().each([&](Entity entity, Damaging& dmgEntity, Motion& fireballMotion) {
+        if (dmgEntity.type == DAMAGING_TYPE::FIREBALL) {
             // calculate direction from angle
             vec2 direction = vec2(cos(fireballMotion.angle), sin(fireballMotion.angle));
             direction = normalize(direction);
@@ -1716,7 +1712,7 @@ void WorldSystem::accelerateFireballs(float elapsed_ms) {
             fireballMotion.velocity.x += (direction.x) * FIREBALL_ACCELERATION * (elapsed_ms / 1000);
             fireballMotion.velocity.y += (direction.y) * FIREBALL_ACCELERATION * (elapsed_ms / 1000);
         }
-    }
+    });
 }
 
 void WorldSystem::updateHomingProjectiles(float elapsed_ms) {
@@ -1725,8 +1721,8 @@ void WorldSystem::updateHomingProjectiles(float elapsed_ms) {
         Motion& projectileM = registry.motions.get(entity);
 
         // check if target entity still exists
-        if(!registry.motions.has(projectile.targetEntity)) {
-            registry.remove_all_components_of(entity);
+        if(!registry.valid(projectile.targetEntity)) {
+            registry.destroy_deferred(entity);
             continue;
         }
 
@@ -3,7 +3,7 @@
 // stlib
 #include <vector>
 #include <random>
-#include <unordered_set>
+#include <bitset>
 
 // internal 
 #include <render_system.hpp>
@@ -92,8 +92,8 @@ private:
 	float tutorialDelayTimer = 0.0f; 
     bool hasSwitchedToTutorial = false;
 
-	std::unordered_set<std::string> encounteredEnemies;
-	std::unordered_set<std::string> encounteredCollectibles;
+	std::bitset<enemy_type_count> encounteredEnemies;
+	std::bitset<collectible_type_count> encounteredCollectibles;
 
 	Entity playerEntity;
 
@@ -196,7 +196,7 @@ private:
 	void updateEnemyTutorial();
 	void updateCollectibleTutorial();
 	void updateHomingProjectiles(float elapsed_ms);
-	void updateEquippedPosition();
+	void updateEquippedAim();
 	void updateMouseTexturePosition(vec2 mousePos);
 	void equipItem(INVENTORY_ITEM item, bool wasCollected = false);
 	void unEquipItem();